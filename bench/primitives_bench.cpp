@@ -0,0 +1,305 @@
+/**
+ * @file primitives_bench.cpp
+ * @brief Microbenchmarks das primitivas de sincronização usadas pelas mesas, isoladas
+ *
+ * Mede o custo bruto de cada primitiva de 1 até todos os núcleos, para atribuir a
+ * primitivas específicas as diferenças de vazão vistas em table_bench:
+ * - semaphore: std::binary_semaphore acquire/release (palitos da SemaphoreDiningTable)
+ * - monitor: pthread_mutex + pthread_cond_wait/signal, no padrão de pickup_forks
+ * - state: Philosopher::getState/setState sob contenção
+ *
+ * Padrões:
+ * - own: cada thread usa a sua própria primitiva (custo sem contenção)
+ * - shared: todas as threads disputam a mesma primitiva
+ * - pingpong: duas threads passam a vez uma para a outra
+ * - ring: cada thread passa a vez para a vizinha, como filósofos numa mesa
+ *
+ * Compilação:
+ *   g++ bench/primitives_bench.cpp -o bin/primitives_bench -I include -std=c++20 -O2 -pthread
+ *
+ * Uso:
+ *   ./bin/primitives_bench [semaphore|monitor|state|all] [iterações por thread] [máx. threads]
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <semaphore>
+#include <format>
+#include <pthread.h>
+#include "../include/philosophers.h"
+#include "../include/lock_profiler.h"
+
+/**
+ * @brief Executa body(índice) em numThreads threads liberadas ao mesmo tempo
+ * @return Segundos entre a liberação e o fim da última thread
+ */
+template <typename Body>
+double runThreads(int numThreads, Body body) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back([&, i] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            body(i);
+        });
+    }
+
+    while (ready.load() < numThreads) {
+        std::this_thread::yield();
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Imprime uma linha do relatório
+ * @param operations Operações (ou passagens de vez) feitas por todas as threads juntas
+ */
+void printRow(const std::string& primitive, const std::string& pattern, int numThreads,
+              uint64_t operations, double seconds) {
+    std::cout << std::format("{:<34} {:<9} {:>7} {:>12.1f} {:>14.0f}\n", primitive, pattern, numThreads,
+                             seconds * 1e9 / operations, operations / seconds);
+}
+
+void printHeader(const std::string& title) {
+    std::cout << "\n=== " << title << " ===\n"
+              << std::format("{:<34} {:<9} {:>7} {:>12} {:>14}\n", "primitiva", "padrão", "threads", "ns/op",
+                             "ops/s");
+}
+
+/**
+ * @brief Quantidades de threads medidas: 1, 2, 4, ... até maxThreads (sempre incluído)
+ * @param minThreads Menor quantidade que o padrão aceita
+ */
+std::vector<int> threadCounts(int minThreads, int maxThreads) {
+    std::vector<int> counts;
+    for (int n = 1; n < maxThreads; n *= 2) {
+        if (n >= minThreads) {
+            counts.push_back(n);
+        }
+    }
+    counts.push_back(std::max(minThreads, maxThreads));
+    return counts;
+}
+
+/**
+ * @brief std::binary_semaphore: acquire/release sem e com contenção, e passagem de vez
+ */
+void semaphoreBench(int iterations, int maxThreads) {
+    printHeader("std::binary_semaphore");
+
+    for (int n : threadCounts(1, maxThreads)) {
+        std::vector<std::unique_ptr<std::binary_semaphore>> own;
+        for (int i = 0; i < n; i++) {
+            own.push_back(std::make_unique<std::binary_semaphore>(1));
+        }
+        double seconds = runThreads(n, [&](int index) {
+            for (int i = 0; i < iterations; i++) {
+                own[index]->acquire();
+                own[index]->release();
+            }
+        });
+        printRow("acquire+release", "own", n, uint64_t(n) * iterations, seconds);
+    }
+
+    for (int n : threadCounts(1, maxThreads)) {
+        std::binary_semaphore shared(1);
+        double seconds = runThreads(n, [&](int) {
+            for (int i = 0; i < iterations; i++) {
+                shared.acquire();
+                shared.release();
+            }
+        });
+        printRow("acquire+release", "shared", n, uint64_t(n) * iterations, seconds);
+    }
+
+    // Passagem de vez: a thread i espera o seu semáforo e libera o da seguinte
+    for (int n : threadCounts(2, maxThreads)) {
+        std::vector<std::unique_ptr<std::binary_semaphore>> turns;
+        for (int i = 0; i < n; i++) {
+            turns.push_back(std::make_unique<std::binary_semaphore>(i == 0 ? 1 : 0));
+        }
+        double seconds = runThreads(n, [&](int index) {
+            for (int i = 0; i < iterations; i++) {
+                turns[index]->acquire();
+                turns[(index + 1) % n]->release();
+            }
+        });
+        printRow("acquire -> release vizinho", n == 2 ? "pingpong" : "ring", n, uint64_t(n) * iterations, seconds);
+    }
+}
+
+/**
+ * @brief Monitor POSIX: lock/unlock e a passagem de vez por pthread_cond_wait/signal
+ *
+ * A passagem reproduz pickup_forks/return_forks: um mutex único e uma condição por
+ * thread; quem espera testa a vez em laço com pthread_cond_wait, e quem passa a vez
+ * a altera e sinaliza a condição da vizinha com o mutex travado.
+ */
+void monitorBench(int iterations, int maxThreads) {
+    printHeader("pthread_mutex / pthread_cond");
+
+    for (int n : threadCounts(1, maxThreads)) {
+        std::vector<pthread_mutex_t> own(n);
+        for (auto& mutex : own) {
+            pthread_mutex_init(&mutex, NULL);
+        }
+        double seconds = runThreads(n, [&](int index) {
+            for (int i = 0; i < iterations; i++) {
+                pthread_mutex_lock(&own[index]);
+                pthread_mutex_unlock(&own[index]);
+            }
+        });
+        for (auto& mutex : own) {
+            pthread_mutex_destroy(&mutex);
+        }
+        printRow("pthread_mutex lock+unlock", "own", n, uint64_t(n) * iterations, seconds);
+    }
+
+    for (int n : threadCounts(1, maxThreads)) {
+        pthread_mutex_t shared;
+        pthread_mutex_init(&shared, NULL);
+        double seconds = runThreads(n, [&](int) {
+            for (int i = 0; i < iterations; i++) {
+                pthread_mutex_lock(&shared);
+                pthread_mutex_unlock(&shared);
+            }
+        });
+        pthread_mutex_destroy(&shared);
+        printRow("pthread_mutex lock+unlock", "shared", n, uint64_t(n) * iterations, seconds);
+    }
+
+    // O mutex das mesas POSIX, com o custo do perfilador quando PHILOSOPHERS_LOCK_PROFILE=1
+    for (int n : threadCounts(1, maxThreads)) {
+        ProfiledPthreadMutex shared("primitives_bench::mutex");
+        double seconds = runThreads(n, [&](int) {
+            for (int i = 0; i < iterations; i++) {
+                shared.lock(LockSite::PICKUP_FORKS);
+                shared.unlock();
+            }
+        });
+        printRow("ProfiledPthreadMutex lock+unlock", "shared", n, uint64_t(n) * iterations, seconds);
+    }
+
+    for (int n : threadCounts(2, maxThreads)) {
+        ProfiledPthreadMutex mutex("primitives_bench::monitor");
+        std::vector<pthread_cond_t> cond(n);
+        for (auto& c : cond) {
+            pthread_cond_init(&c, NULL);
+        }
+        int turn = 0;
+
+        double seconds = runThreads(n, [&](int index) {
+            int next = (index + 1) % n;
+            for (int i = 0; i < iterations; i++) {
+                mutex.lock(LockSite::PICKUP_FORKS);
+                while (turn != index) {
+                    mutex.wait(&cond[index]);
+                }
+                mutex.unlock();
+
+                mutex.lock(LockSite::RETURN_FORKS);
+                turn = next;
+                pthread_cond_signal(&cond[next]);
+                mutex.unlock();
+            }
+        });
+        for (auto& c : cond) {
+            pthread_cond_destroy(&c);
+        }
+        printRow("cond_wait -> cond_signal vizinho", n == 2 ? "pingpong" : "ring", n, uint64_t(n) * iterations,
+                 seconds);
+    }
+}
+
+/**
+ * @brief Philosopher::setState/getState, que cada mesa chama várias vezes por refeição
+ *
+ * setState também publica no quadro da mesa (um CAS na linha de cache do próprio
+ * assento), então o custo medido inclui essa publicação.
+ */
+void stateBench(int iterations, int maxThreads) {
+    printHeader("Philosopher::getState / setState");
+
+    auto measure = [&](int n, const std::string& pattern) {
+        int seats = std::max(n, 2);
+        EventChannel events(-1);
+        std::unique_ptr<CacheLine[]> boardStorage(new CacheLine[CacheLine::countFor(SnapshotBoard::bytesFor(seats))]);
+        std::unique_ptr<CacheLine[]> checkerStorage(new CacheLine[CacheLine::countFor(SafetyChecker::bytesFor(seats))]);
+        SnapshotBoard* board = SnapshotBoard::create(boardStorage.get(), seats);
+        SafetyChecker* checker = SafetyChecker::create(checkerStorage.get(), seats, &events);
+
+        std::vector<std::unique_ptr<Philosopher>> philosophers;
+        for (int i = 0; i < seats; i++) {
+            philosophers.push_back(std::make_unique<Philosopher>(i, &events, board, checker, i));
+        }
+
+        std::atomic<int> sink{0};
+        double seconds = runThreads(n, [&](int index) {
+            Philosopher& self = *philosophers[pattern == "shared" ? 0 : index];
+            Philosopher& left = *philosophers[(index + seats - 1) % seats];
+            Philosopher& right = *philosophers[(index + 1) % seats];
+            int seen = 0;
+            for (int i = 0; i < iterations; i++) {
+                self.setState(i % 2 ? State::HUNGRY : State::EATING);
+                if (pattern == "ring") {
+                    // Como test(): o filósofo olha os dois vizinhos antes de comer
+                    seen += left.getState() == State::EATING;
+                    seen += right.getState() == State::EATING;
+                } else {
+                    seen += self.getState() == State::EATING;
+                }
+            }
+            sink.fetch_add(seen, std::memory_order_relaxed);
+        });
+        printRow(pattern == "ring" ? "setState + 2x getState vizinhos" : "setState + getState", pattern, n,
+                 uint64_t(n) * iterations, seconds);
+    };
+
+    for (const char* pattern : {"own", "shared", "ring"}) {
+        for (int n : threadCounts(1, maxThreads)) {
+            measure(n, pattern);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "all";
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 200000;
+    int maxThreads = argc > 3 ? std::stoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << std::format("{} núcleos, até {} threads, {} iterações por thread\n",
+                             std::thread::hardware_concurrency(), maxThreads, iterations);
+
+    if (mode == "semaphore" || mode == "all") {
+        semaphoreBench(iterations, maxThreads);
+    }
+    if (mode == "monitor" || mode == "all") {
+        monitorBench(iterations, maxThreads);
+    }
+    if (mode == "state" || mode == "all") {
+        stateBench(iterations, maxThreads);
+    }
+    if (mode != "semaphore" && mode != "monitor" && mode != "state" && mode != "all") {
+        std::cerr << "Modo desconhecido: " << mode << std::endl;
+        return 1;
+    }
+
+    if (LockProfiler::enabled()) {
+        std::cout << LockProfiler::report();
+    }
+    return 0;
+}
@@ -0,0 +1,490 @@
+/**
+ * @file table_bench.cpp
+ * @brief Benchmarks de mesa inteira: compara as implementações sob cargas controladas
+ *
+ * Compilação:
+ *   g++ bench/table_bench.cpp -o bin/table_bench -I include -std=c++20 -O2 -pthread
+ *
+ * Uso:
+ *   ./bin/table_bench fairness [filósofos] [segundos]
+ *   ./bin/table_bench semaphore [filósofos] [segundos]
+ *   ./bin/table_bench shm [filósofos] [segundos] [processos]
+ *   ./bin/table_bench alloc [filósofos] [segundos]
+ *   ./bin/table_bench safety [filósofos] [segundos]
+ *   ./bin/table_bench timers [filósofos] [segundos]
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <vector>
+#include <sys/resource.h>
+#include "../src/posix_aging.cpp"
+#include "../src/posix_fair.cpp"
+#include "../src/semaphore.cpp"
+#include "../src/posix.cpp"
+#include "../src/shared_memory.cpp"
+
+/// Alocações no heap feitas pelo processo (contadas pelos operator new abaixo)
+static std::atomic<uint64_t> heapAllocations{0};
+
+/**
+ * @brief Par único de alocação/liberação por trás de todas as formas de operator new/delete
+ *
+ * Fora de linha para que o compilador não junte o malloc/free daqui com as chamadas
+ * new/delete do resto do programa (o que gera -Wmismatched-new-delete).
+ * @param alignment 0 para o alinhamento padrão do malloc
+ * @return nullptr se faltar memória
+ */
+[[gnu::noinline]] static void* countedAllocate(std::size_t size, std::size_t alignment) noexcept {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment == 0) {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+[[gnu::noinline]] static void countedRelease(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+static void* countedAllocateOrThrow(std::size_t size, std::size_t alignment) {
+    if (void* pointer = countedAllocate(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) {
+    return countedAllocateOrThrow(size, 0);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocateOrThrow(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    countedRelease(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    countedRelease(pointer);
+}
+
+/**
+ * @brief Carga assimétrica: filósofos pares são "gulosos" (quase não pensam)
+ * @param table A mesa a ser configurada
+ */
+void applySkewedWorkload(DiningTable& table) {
+    for (size_t i = 0; i < table.getNumPhilosophers(); i++) {
+        if (i % 2 == 0) {
+            table.setPhilosopherTiming(i, 0, 1, 2);   // guloso: pensa 0-1 ms
+        } else {
+            table.setPhilosopherTiming(i, 5, 20, 2);  // moderado: pensa 5-20 ms
+        }
+    }
+}
+
+/**
+ * @brief Executa uma mesa por um tempo fixo e imprime vazão, percentis de espera
+ * e a média de filósofos comendo simultaneamente
+ * @param name Nome exibido no relatório
+ * @param table A mesa (precisa expor stop(), getWaitHistogram() e getAverageEaters())
+ * @param seconds Duração da medição
+ */
+template <typename Table>
+void runFairnessCase(const std::string& name, Table& table, int seconds) {
+    applySkewedWorkload(table);
+
+    std::thread runner([&table] { table.run(); });
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    double averageEaters = table.getAverageEaters();
+    table.stop();
+    runner.join();
+
+    const LatencyHistogram& wait = table.getWaitHistogram();
+    std::cout << std::format("{:<8} refeições={:>8} refeições/s={:>10.1f} "
+                             "espera(µs) p50={:>7} p99={:>7} p999={:>7} max={:>7} "
+                             "comendo={:.2f}/{}\n",
+                             name, wait.count(), static_cast<double>(wait.count()) / seconds,
+                             wait.percentile(50), wait.percentile(99), wait.percentile(99.9),
+                             wait.max(), averageEaters, table.getNumPhilosophers() / 2);
+}
+
+/**
+ * @brief Compara a mesa com aging com a mesa FIFO sob carga assimétrica
+ */
+void fairnessBench(int numPhilosophers, int seconds) {
+    std::cout << std::format("fairness: {} filósofos, {} s por mesa, pares gulosos\n",
+                             numPhilosophers, seconds);
+    {
+        PosixAgingDiningTable table(numPhilosophers, -1);
+        runFairnessCase("aging", table, seconds);
+    }
+    {
+        PosixFairDiningTable table(numPhilosophers, -1);
+        runFairnessCase("fifo", table, seconds);
+    }
+}
+
+/**
+ * @brief Compara as estratégias livres de deadlock da mesa com semáforos
+ *
+ * Todos os filósofos pensam 0-1 ms e comem 1 ms, maximizando a disputa.
+ */
+void semaphoreBench(int numPhilosophers, int seconds) {
+    std::cout << std::format("semaphore: {} filósofos, {} s por estratégia, carga uniforme\n",
+                             numPhilosophers, seconds);
+
+    const std::pair<const char*, SemaphoreStrategy> strategies[] = {
+        {"hierarquia", SemaphoreStrategy::RESOURCE_HIERARCHY},
+        {"garçom", SemaphoreStrategy::BUTLER},
+        {"recuo", SemaphoreStrategy::TRY_BACKOFF},
+    };
+
+    for (const auto& [name, strategy] : strategies) {
+        SemaphoreDiningTable table(numPhilosophers, -1, strategy);
+        for (int i = 0; i < numPhilosophers; i++) {
+            table.setPhilosopherTiming(i, 0, 1, 1);
+        }
+
+        std::thread runner([&table] { table.run(); });
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+        table.stop();
+        runner.join();
+
+        uint64_t meals = table.getMeals();
+        std::cout << std::format("{:<11} refeições={:>8} refeições/s={:>10.1f} "
+                                 "tentativas={:>8} tentativas/refeição={:.3f}\n",
+                                 name, meals, static_cast<double>(meals) / seconds, table.getRetries(),
+                                 meals > 0 ? static_cast<double>(table.getRetries()) / meals : 0.0);
+    }
+}
+
+/**
+ * @brief Executa uma mesa com carga uniforme e retorna as refeições por segundo
+ * @param table A mesa (precisa expor stop() e getMeals())
+ * @param seconds Duração da medição
+ */
+template <typename Table>
+double measureMealsPerSecond(Table& table, int seconds) {
+    for (size_t i = 0; i < table.getNumPhilosophers(); i++) {
+        table.setPhilosopherTiming(i, 0, 1, 1);
+    }
+
+    std::thread runner([&table] { table.run(); });
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    table.stop();
+    runner.join();
+
+    return static_cast<double>(table.getMeals()) / seconds;
+}
+
+/**
+ * @brief Compara a mesa POSIX em um processo com a mesa em memória compartilhada
+ */
+void sharedMemoryBench(int numPhilosophers, int seconds, int numWorkers) {
+    std::cout << std::format("shm: {} filósofos, {} s por mesa, {} processos trabalhadores\n",
+                             numPhilosophers, seconds, numWorkers);
+    {
+        PosixDiningTable table(numPhilosophers, -1);
+        std::cout << std::format("{:<10} refeições/s={:>10.1f}\n", "processo", measureMealsPerSecond(table, seconds));
+    }
+    {
+        SharedMemoryDiningTable table(numPhilosophers, -1, numWorkers);
+        std::cout << std::format("{:<10} refeições/s={:>10.1f}\n", "shm", measureMealsPerSecond(table, seconds));
+    }
+}
+
+/**
+ * @brief Refeições concluídas por uma mesa (as mesas justas contam pelo histograma de espera)
+ */
+template <typename Table>
+uint64_t mealsOf(Table& table) {
+    if constexpr (requires { table.getMeals(); }) {
+        return table.getMeals();
+    } else {
+        return table.getWaitHistogram().count();
+    }
+}
+
+/**
+ * @brief Mede as alocações no heap por refeição em regime permanente
+ *
+ * Os eventos vão para um socket local esvaziado por outra thread, de modo que todas
+ * as mensagens são de fato montadas e enviadas. A primeira metade do tempo aquece a
+ * mesa (criação das threads, buffers por thread); só a segunda metade é medida.
+ */
+template <typename Table>
+void runAllocationCase(const std::string& name, Table& table, int seconds) {
+    for (size_t i = 0; i < table.getNumPhilosophers(); i++) {
+        table.setPhilosopherTiming(i, 0, 1, 1);
+    }
+
+    std::thread runner([&table] { table.run(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(500 * seconds));
+
+    uint64_t allocationsBefore = heapAllocations.load();
+    uint64_t mealsBefore = mealsOf(table);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500 * seconds));
+    uint64_t allocations = heapAllocations.load() - allocationsBefore;
+    uint64_t meals = mealsOf(table) - mealsBefore;
+
+    table.stop();
+    runner.join();
+
+    std::cout << std::format("{:<11} refeições={:>8} alocações={:>8} alocações/refeição={:.3f}\n",
+                             name, meals, allocations,
+                             meals > 0 ? static_cast<double>(allocations) / meals : 0.0);
+}
+
+void allocationBench(int numPhilosophers, int seconds) {
+    std::cout << std::format("alloc: {} filósofos, {} s por mesa, eventos enviados a um socket local\n",
+                             numPhilosophers, seconds);
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) < 0) {
+        std::cerr << "socketpair falhou" << std::endl;
+        return;
+    }
+    std::thread drain([reader = sockets[1]] {
+        char buffer[65536];
+        while (recv(reader, buffer, sizeof(buffer), 0) > 0) {
+        }
+    });
+
+    int events = sockets[0];
+    {
+        PosixDiningTable table(numPhilosophers, events);
+        runAllocationCase("posix", table, seconds);
+    }
+    {
+        PosixAgingDiningTable table(numPhilosophers, events);
+        runAllocationCase("aging", table, seconds);
+    }
+    {
+        PosixFairDiningTable table(numPhilosophers, events);
+        runAllocationCase("fifo", table, seconds);
+    }
+    {
+        SemaphoreDiningTable table(numPhilosophers, events, SemaphoreStrategy::RESOURCE_HIERARCHY);
+        runAllocationCase("hierarquia", table, seconds);
+    }
+    {
+        SemaphoreDiningTable table(numPhilosophers, events, SemaphoreStrategy::TRY_BACKOFF);
+        runAllocationCase("recuo", table, seconds);
+    }
+
+    shutdown(events, SHUT_RDWR);
+    drain.join();
+    close(sockets[0]);
+    close(sockets[1]);
+}
+
+/**
+ * @brief Mede o custo do verificador de segurança: mesma mesa com e sem verificação,
+ * sem pausas para pensar ou comer (taxa máxima de eventos)
+ *
+ * As medições com e sem verificação se alternam em SAFETY_ROUNDS rodadas e o custo
+ * é calculado pelas medianas, para que ruído do agendador não pese só em um lado.
+ */
+constexpr int SAFETY_ROUNDS = 5;
+
+template <typename Table, typename... Args>
+void runSafetyCase(const std::string& name, int numPhilosophers, int seconds, Args... args) {
+    std::vector<double> mealsPerSecond[2];
+    uint64_t violations = 0;
+    auto window = std::chrono::milliseconds(std::max(200, seconds * 1000 / (4 * SAFETY_ROUNDS)));
+
+    for (int round = 0; round < SAFETY_ROUNDS; round++) {
+        for (int checked = 0; checked < 2; checked++) {
+            SafetyChecker::setEnabled(checked == 1);
+            Table table(numPhilosophers, -1, args...);
+            for (int i = 0; i < numPhilosophers; i++) {
+                table.setPhilosopherTiming(i, 0, 0, 0);
+            }
+
+            std::thread runner([&table] { table.run(); });
+            std::this_thread::sleep_for(window);
+            uint64_t before = mealsOf(table);
+            std::this_thread::sleep_for(window);
+            mealsPerSecond[checked].push_back((mealsOf(table) - before) / std::chrono::duration<double>(window).count());
+            table.stop();
+            runner.join();
+            violations += table.getSafetyViolations();
+        }
+    }
+
+    double median[2];
+    for (int checked = 0; checked < 2; checked++) {
+        std::sort(mealsPerSecond[checked].begin(), mealsPerSecond[checked].end());
+        median[checked] = mealsPerSecond[checked][SAFETY_ROUNDS / 2];
+    }
+    std::cout << std::format("{:<11} sem={:>11.1f}/s com={:>11.1f}/s custo={:>6.2f}% violações={}\n",
+                             name, median[0], median[1],
+                             median[0] > 0 ? 100.0 * (1.0 - median[1] / median[0]) : 0.0, violations);
+}
+
+void safetyBench(int numPhilosophers, int seconds) {
+    std::cout << std::format("safety: {} filósofos, ~{} s por mesa, medianas de {} rodadas, sem pausas\n",
+                             numPhilosophers, seconds, SAFETY_ROUNDS);
+    runSafetyCase<PosixDiningTable>("posix", numPhilosophers, seconds);
+    runSafetyCase<PosixAgingDiningTable>("aging", numPhilosophers, seconds);
+    runSafetyCase<PosixFairDiningTable>("fifo", numPhilosophers, seconds);
+    runSafetyCase<SemaphoreDiningTable>("hierarquia", numPhilosophers, seconds, SemaphoreStrategy::RESOURCE_HIERARCHY);
+    runSafetyCase<SemaphoreDiningTable>("garçom", numPhilosophers, seconds, SemaphoreStrategy::BUTLER);
+    runSafetyCase<SemaphoreDiningTable>("recuo", numPhilosophers, seconds, SemaphoreStrategy::TRY_BACKOFF);
+    SafetyChecker::setEnabled(true);
+}
+
+/**
+ * @brief Trocas de contexto (voluntárias e involuntárias) de todas as threads do processo
+ */
+long contextSwitches() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+/**
+ * @brief Compara sleep_for com a roda de temporização em uma mesa POSIX com esperas
+ * curtas e frequentes (pensa 5-50 ms, come 10 ms)
+ */
+void timerBench(int numPhilosophers, int seconds) {
+    std::cout << std::format("timers: {} filósofos, {} s por modo, pensa 5-50 ms, come 10 ms\n",
+                             numPhilosophers, seconds);
+
+    bool wasEnabled = TimerWheel::enabled();
+    for (bool wheel : {false, true}) {
+        TimerWheel::setEnabled(wheel);
+        TimerWheel::jitter().reset();
+        uint64_t wakeupsBefore = wheel ? TimerWheel::instance().getTimerWakeups() : 0;
+        uint64_t expiredBefore = wheel ? TimerWheel::instance().getExpired() : 0;
+        long switchesBefore = contextSwitches();
+
+        PosixDiningTable table(numPhilosophers, -1);
+        for (int i = 0; i < numPhilosophers; i++) {
+            table.setPhilosopherTiming(i, 5, 50, 10);
+        }
+        std::thread runner([&table] { table.run(); });
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+        table.stop();
+        runner.join();
+
+        const LatencyHistogram& jitter = TimerWheel::jitter();
+        std::string wakeups = "-";
+        if (wheel) {
+            uint64_t timerWakeups = TimerWheel::instance().getTimerWakeups() - wakeupsBefore;
+            uint64_t expired = TimerWheel::instance().getExpired() - expiredBefore;
+            wakeups = std::format("{} ({:.1f} esperas/despertar)", timerWakeups,
+                                  timerWakeups > 0 ? static_cast<double>(expired) / timerWakeups : 0.0);
+        }
+        std::cout << std::format("{:<9} refeições/s={:>9.1f} jitter(µs) p50={:>6} p99={:>6} max={:>6} "
+                                 "trocas de contexto={:>8} despertares do timerfd={}\n",
+                                 wheel ? "roda" : "sleep_for", static_cast<double>(table.getMeals()) / seconds,
+                                 jitter.percentile(50), jitter.percentile(99), jitter.max(),
+                                 contextSwitches() - switchesBefore, wakeups);
+    }
+    TimerWheel::setEnabled(wasEnabled);
+}
+
+int main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "fairness";
+    int numPhilosophers = argc > 2 ? std::stoi(argv[2]) : 10;
+    int seconds = argc > 3 ? std::stoi(argv[3]) : 5;
+
+    if (mode == "fairness") {
+        fairnessBench(numPhilosophers, seconds);
+    } else if (mode == "semaphore") {
+        semaphoreBench(numPhilosophers, seconds);
+    } else if (mode == "shm") {
+        sharedMemoryBench(numPhilosophers, seconds, argc > 4 ? std::stoi(argv[4]) : 2);
+    } else if (mode == "alloc") {
+        allocationBench(numPhilosophers, seconds);
+    } else if (mode == "safety") {
+        safetyBench(numPhilosophers, seconds);
+    } else if (mode == "timers") {
+        timerBench(numPhilosophers, seconds);
+    } else {
+        std::cerr << "Modo desconhecido: " << mode << std::endl;
+        return 1;
+    }
+
+    // Com PHILOSOPHERS_LOCK_PROFILE=1, mostra a contenção dos locks durante o benchmark
+    if (LockProfiler::enabled()) {
+        std::cout << LockProfiler::report();
+    }
+    return 0;
+}
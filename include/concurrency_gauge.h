@@ -0,0 +1,65 @@
+/**
+ * @file concurrency_gauge.h
+ * @brief Medidor da média temporal de filósofos comendo simultaneamente
+ */
+
+#ifndef CONCURRENCY_GAUGE_H
+#define CONCURRENCY_GAUGE_H
+
+#include <chrono>
+
+/**
+ * @brief Integra no tempo o número de filósofos comendo
+ *
+ * Não é thread-safe: deve ser atualizado sob o mutex do monitor da mesa.
+ */
+class ConcurrencyGauge {
+public:
+    ConcurrencyGauge() : start(std::chrono::steady_clock::now()), lastChange(start) {}
+
+    /**
+     * @brief Registra que um filósofo começou a comer
+     */
+    void increment() {
+        advance();
+        current++;
+    }
+
+    /**
+     * @brief Registra que um filósofo terminou de comer
+     */
+    void decrement() {
+        advance();
+        current--;
+    }
+
+    /**
+     * @brief Retorna quantos filósofos estão comendo agora
+     */
+    int value() const {
+        return current;
+    }
+
+    /**
+     * @brief Retorna a média de filósofos comendo desde a criação
+     */
+    double average() {
+        advance();
+        double elapsed = std::chrono::duration<double>(lastChange - start).count();
+        return elapsed > 0 ? weightedSum / elapsed : 0.0;
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;      ///< Início da medição
+    std::chrono::steady_clock::time_point lastChange; ///< Última atualização da integral
+    double weightedSum = 0.0;                          ///< Integral de (comendo × segundos)
+    int current = 0;                                   ///< Filósofos comendo agora
+
+    void advance() {
+        auto now = std::chrono::steady_clock::now();
+        weightedSum += current * std::chrono::duration<double>(now - lastChange).count();
+        lastChange = now;
+    }
+};
+
+#endif // CONCURRENCY_GAUGE_H
@@ -10,7 +10,11 @@
 #include <mutex>
 #include <memory>
 #include <iostream>
+#include <atomic>
 #include "philosophers.h"
+#include "event_channel.h"
+#include "table_snapshot.h"
+#include "safety_checker.h"
 
 #include <unistd.h>
 #include <sys/socket.h>
@@ -26,8 +30,9 @@ public:
     /**
      * @brief Construtor para a mesa
      * @param numPhilosophers O número de filósofos na mesa (padrão: 5)
+     * @param firstId ID do primeiro filósofo (diferente de 0 quando a mesa é um segmento de um anel maior)
      */
-    DiningTable(int numPhilosophers, int socketnum);
+    DiningTable(int numPhilosophers, int socketnum, int firstId = 0);
 
     /**
      * @brief Destrutor virtual
@@ -40,6 +45,46 @@ public:
      */
     virtual void run() = 0;
 
+    /**
+     * @brief Para a execução da simulação
+     * Os filósofos terminam o ciclo atual e run() retorna
+     */
+    virtual void stop() {
+        running = false;
+    }
+
+    /**
+     * @brief Retorna um resumo das estatísticas da mesa em uma linha
+     * As classes derivadas podem acrescentar métricas próprias
+     */
+    virtual std::string stats();
+
+    /**
+     * @brief Copia estados, refeições e donos dos palitos de forma consistente
+     *
+     * Não usa nenhum lock dos filósofos ou da mesa: lê o quadro versionado em que
+     * cada mudança é publicada. Pode ser chamado de qualquer thread.
+     * @param out Destino (os vetores são reaproveitados entre chamadas)
+     * @return false se não foi possível obter uma cópia consistente
+     */
+    bool snapshot(TableSnapshot& out) const {
+        return snapshotBoard->read(out);
+    }
+
+    /**
+     * @brief Número de violações de segurança detectadas pelo verificador
+     */
+    uint64_t getSafetyViolations() const {
+        return safetyChecker->violations();
+    }
+
+    /**
+     * @brief Retorna o canal de eventos da mesa (inscrição e prefixo)
+     */
+    EventChannel& getEvents() {
+        return events;
+    }
+
     /**
      * @brief Retorna o número de filósofos na mesa
      * @return O número de filósofos
@@ -48,22 +93,64 @@ public:
         return philosophers.size();
     }
 
+    /**
+     * @brief Ajusta os tempos de pensar e comer de um filósofo (usado em benchmarks)
+     * @param id O ID do filósofo
+     * @param thinkMinMs Tempo mínimo pensando (ms)
+     * @param thinkMaxMs Tempo máximo pensando (ms)
+     * @param eatMs Tempo comendo (ms)
+     */
+    void setPhilosopherTiming(int id, int thinkMinMs, int thinkMaxMs, int eatMs) {
+        philosophers[id]->setTiming(thinkMinMs, thinkMaxMs, eatMs);
+    }
+
 protected:
-    int socketID;
+    std::atomic<bool> running{true}; ///< Flag atômica para controlar a execução das threads
+    EventChannel events;             ///< Canal de eventos para o cliente
+
+    std::unique_ptr<CacheLine[]> snapshotStorage; ///< Memória do quadro padrão
+    SnapshotBoard* snapshotBoard;                ///< Quadro em uso pelos filósofos
+    std::unique_ptr<CacheLine[]> safetyStorage;   ///< Memória do verificador padrão
+    SafetyChecker* safetyChecker;                ///< Verificador em uso pelos filósofos
+
+    /**
+     * @brief Troca o quadro em que os filósofos publicam (usado antes de run())
+     */
+    void useSnapshotBoard(SnapshotBoard* board) {
+        snapshotBoard = board;
+        for (auto& philosopher : philosophers) {
+            philosopher->setSnapshotBoard(board);
+        }
+    }
+
+    /**
+     * @brief Troca o verificador usado pelos filósofos (usado antes de run())
+     */
+    void useSafetyChecker(SafetyChecker* checker) {
+        safetyChecker = checker;
+        for (auto& philosopher : philosophers) {
+            philosopher->setSafetyChecker(checker);
+        }
+    }
 
     std::vector<std::unique_ptr<Philosopher>> philosophers; ///< Vetor de filósofos
     std::vector<std::unique_ptr<std::mutex>> chopsticks;    ///< Vetor de mutex para os palitos
 };
 
 // Implementação do construtor
-inline DiningTable::DiningTable(int numPhilosophers, int socketnum) : socketID(socketnum) {
+inline DiningTable::DiningTable(int numPhilosophers, int socketnum, int firstId)
+    : events(socketnum),
+      snapshotStorage(new CacheLine[CacheLine::countFor(SnapshotBoard::bytesFor(numPhilosophers))]),
+      snapshotBoard(SnapshotBoard::create(snapshotStorage.get(), numPhilosophers)),
+      safetyStorage(new CacheLine[CacheLine::countFor(SafetyChecker::bytesFor(numPhilosophers))]),
+      safetyChecker(SafetyChecker::create(safetyStorage.get(), numPhilosophers, &events)) {
     std::string msg = std::format("DiningTable: Inicializando com {} filósofos\n ", numPhilosophers); 
-    send(socketID, msg.c_str(), msg.size(), 0);
+    events.send(msg);
     
     // Inicializa o vetor de filósofos
     philosophers.clear();
     for (int i = 0; i < numPhilosophers; i++) {
-        philosophers.push_back(std::make_unique<Philosopher>(i, socketID));
+        philosophers.push_back(std::make_unique<Philosopher>(firstId + i, &events, snapshotBoard, safetyChecker, i));
     }
     
     // Inicializa o vetor de palitos (mutex)
@@ -72,8 +159,29 @@ inline DiningTable::DiningTable(int numPhilosophers, int socketnum) : socketID(s
         chopsticks.push_back(std::make_unique<std::mutex>());
     }
     
-    msg = std::format("DiningTable: Criados {} filósofos e {} palitos", philosophers.size(), chopsticks.size());
-    send(socketID, msg.c_str(), msg.size(), 0);
+    msg = std::format("DiningTable: Criados {} filósofos e {} palitos\n", philosophers.size(), chopsticks.size());
+    events.send(msg);
+}
+
+inline std::string DiningTable::stats() {
+    TableSnapshot view;
+    if (!snapshot(view)) {
+        return "estado indisponível";
+    }
+
+    // Estado de cada filósofo: P (pensando), F (com fome), C (comendo)
+    uint64_t meals = 0;
+    std::string states;
+    for (size_t i = 0; i < view.states.size(); i++) {
+        meals += view.meals[i];
+        switch (view.states[i]) {
+            case State::THINKING: states += 'P'; break;
+            case State::HUNGRY:   states += 'F'; break;
+            case State::EATING:   states += 'C'; break;
+        }
+    }
+    return std::format("refeições={} estados={} versão={} violações={}", meals, states, view.version,
+                       getSafetyViolations());
 }
 
 #endif // DINING_TABLE_H 
\ No newline at end of file
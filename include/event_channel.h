@@ -0,0 +1,180 @@
+/**
+ * @file event_channel.h
+ * @brief Canal de eventos de uma mesa para o socket do cliente
+ */
+
+#ifndef EVENT_CHANNEL_H
+#define EVENT_CHANNEL_H
+
+#include <atomic>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Buffer de tamanho fixo para montar uma mensagem sem alocar
+ *
+ * Textos são copiados e inteiros são escritos com std::to_chars. O que não
+ * couber no buffer é descartado.
+ */
+class EventBuffer {
+public:
+    static constexpr size_t CAPACITY = 256; ///< Tamanho máximo de uma mensagem
+
+    void clear() {
+        length = 0;
+    }
+
+    void append(std::string_view text) {
+        size_t count = std::min(text.size(), CAPACITY - length);
+        std::memcpy(buffer + length, text.data(), count);
+        length += count;
+    }
+
+    template <typename Integer>
+        requires std::is_integral_v<Integer> && (!std::is_same_v<Integer, bool>) && (!std::is_same_v<Integer, char>)
+    void append(Integer value) {
+        auto [end, error] = std::to_chars(buffer + length, buffer + CAPACITY, value);
+        if (error == std::errc()) {
+            length = end - buffer;
+        }
+    }
+
+    const char* data() const {
+        return buffer;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    char buffer[CAPACITY]; ///< Conteúdo da mensagem
+    size_t length = 0;     ///< Bytes usados
+};
+
+/**
+ * @brief Canal por onde a mesa e seus filósofos enviam eventos ao cliente
+ *
+ * Várias mesas podem compartilhar o mesmo socket; cada uma tem um prefixo próprio
+ * (por exemplo "[mesa 2] ") e pode ser silenciada sem parar a simulação.
+ */
+class EventChannel {
+public:
+    /**
+     * @brief Construtor
+     * @param socket Socket do cliente (-1 descarta os eventos)
+     */
+    explicit EventChannel(int socket) : socket(socket), subscribed(&ownSubscribed) {}
+
+    EventChannel(const EventChannel&) = delete;
+    EventChannel& operator=(const EventChannel&) = delete;
+
+    /**
+     * @brief Envia uma mensagem, precedida do prefixo, se o canal estiver inscrito
+     */
+    void send(const char* data, size_t size) {
+        if (!isActive()) {
+            return;
+        }
+
+        iovec parts[2] = {
+            {const_cast<char*>(prefix), prefixLength},
+            {const_cast<char*>(data), size},
+        };
+        msghdr message{};
+        message.msg_iov = prefixLength > 0 ? parts : parts + 1;
+        message.msg_iovlen = prefixLength > 0 ? 2 : 1;
+        sendmsg(socket, &message, MSG_NOSIGNAL);
+    }
+
+    void send(const std::string& msg) {
+        send(msg.c_str(), msg.size());
+    }
+
+    /**
+     * @brief Monta a mensagem a partir de textos e inteiros e a envia, sem alocar
+     *
+     * Usada nos eventos frequentes (mudanças de estado dos filósofos). A mensagem é
+     * montada em um buffer da própria thread, e nada é montado se o canal não
+     * tiver destino ou estiver silenciado.
+     */
+    template <typename... Parts>
+    void emit(const Parts&... parts) {
+        if (!isActive()) {
+            return;
+        }
+
+        EventBuffer& buffer = threadBuffer();
+        buffer.clear();
+        (appendPart(buffer, parts), ...);
+        send(buffer.data(), buffer.size());
+    }
+
+    /**
+     * @brief Indica se há um destino inscrito para os eventos
+     */
+    bool isActive() const {
+        return socket >= 0 && subscribed->load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Define o prefixo de todas as mensagens (truncado em 31 bytes)
+     */
+    void setPrefix(const std::string& text) {
+        prefixLength = std::min(text.size(), sizeof(prefix) - 1);
+        std::memcpy(prefix, text.data(), prefixLength);
+    }
+
+    /**
+     * @brief Liga ou desliga o envio de eventos
+     */
+    void setSubscribed(bool value) {
+        subscribed->store(value, std::memory_order_relaxed);
+    }
+
+    bool isSubscribed() const {
+        return subscribed->load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Passa a usar uma flag de inscrição externa (por exemplo, em memória
+     * compartilhada, para que processos filhos vejam a mudança)
+     */
+    void shareSubscribedFlag(std::atomic<bool>* location) {
+        location->store(subscribed->load());
+        subscribed = location;
+    }
+
+    int getSocket() const {
+        return socket;
+    }
+
+private:
+    int socket;                        ///< Socket do cliente
+    char prefix[32] = {0};             ///< Prefixo das mensagens
+    size_t prefixLength = 0;           ///< Tamanho do prefixo
+    std::atomic<bool> ownSubscribed{true}; ///< Flag de inscrição padrão
+    std::atomic<bool>* subscribed;     ///< Flag de inscrição em uso
+
+    static EventBuffer& threadBuffer() {
+        thread_local EventBuffer buffer;
+        return buffer;
+    }
+
+    template <typename Part>
+    static void appendPart(EventBuffer& buffer, const Part& part) {
+        if constexpr (std::is_integral_v<Part> && !std::is_same_v<Part, bool> && !std::is_same_v<Part, char>) {
+            buffer.append(part);
+        } else {
+            buffer.append(std::string_view(part));
+        }
+    }
+};
+
+#endif // EVENT_CHANNEL_H
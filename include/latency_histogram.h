@@ -0,0 +1,142 @@
+/**
+ * @file latency_histogram.h
+ * @brief Histograma de latências com buckets logarítmicos e memória fixa
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+/**
+ * @brief Histograma de latências sem alocação e seguro para registro concorrente
+ *
+ * Cada potência de dois é dividida em 8 sub-buckets, o que limita o erro
+ * relativo dos percentis a 12,5%. A unidade dos valores fica a cargo de quem
+ * registra (microssegundos para esperas, nanossegundos para locks).
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int LINEAR_LIMIT = 2 * SUB_BUCKETS; ///< Valores abaixo disso têm bucket exato
+    static constexpr int NUM_BUCKETS = LINEAR_LIMIT + (64 - SUB_BUCKET_BITS - 1) * SUB_BUCKETS;
+
+    /**
+     * @brief Registra uma amostra
+     * @param value O valor medido
+     */
+    void record(uint64_t value) {
+        buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t currentMax = maximum.load(std::memory_order_relaxed);
+        while (value > currentMax &&
+               !maximum.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Retorna o número de amostras registradas
+     */
+    uint64_t count() const {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Retorna a média das amostras (0 se vazio)
+     */
+    double mean() const {
+        uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(sum.load(std::memory_order_relaxed)) / n;
+    }
+
+    /**
+     * @brief Retorna o maior valor registrado
+     */
+    uint64_t max() const {
+        return maximum.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Retorna o percentil pedido (limite superior do bucket correspondente)
+     * @param p Percentil entre 0 e 100
+     */
+    uint64_t percentile(double p) const {
+        uint64_t n = count();
+        if (n == 0) {
+            return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * n);
+        if (rank >= n) {
+            rank = n - 1;
+        }
+
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen > rank) {
+                uint64_t upper = bucketUpperBound(i);
+                return upper < max() ? upper : max();
+            }
+        }
+        return max();
+    }
+
+    /**
+     * @brief Retorna quantas amostras caíram em buckets com limite superior <= value
+     */
+    uint64_t countAtMost(uint64_t value) const {
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS && bucketUpperBound(i) <= value; i++) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+        }
+        return seen;
+    }
+
+    /**
+     * @brief Zera o histograma
+     */
+    void reset() {
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        maximum.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{}; ///< Contadores por bucket
+    std::atomic<uint64_t> total{0};                           ///< Número de amostras
+    std::atomic<uint64_t> sum{0};                             ///< Soma das amostras
+    std::atomic<uint64_t> maximum{0};                         ///< Maior amostra
+
+    static int bucketIndex(uint64_t value) {
+        if (value < LINEAR_LIMIT) {
+            return static_cast<int>(value);
+        }
+        int msb = 63 - std::countl_zero(value);
+        int shift = msb - SUB_BUCKET_BITS;
+        int sub = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        return LINEAR_LIMIT + (msb - SUB_BUCKET_BITS - 1) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t bucketUpperBound(int index) {
+        if (index < LINEAR_LIMIT) {
+            return static_cast<uint64_t>(index);
+        }
+        int msb = (index - LINEAR_LIMIT) / SUB_BUCKETS + SUB_BUCKET_BITS + 1;
+        int sub = (index - LINEAR_LIMIT) % SUB_BUCKETS;
+        int shift = msb - SUB_BUCKET_BITS;
+        uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + sub) << shift;
+        return lower + (uint64_t{1} << shift) - 1;
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,319 @@
+/**
+ * @file lock_profiler.h
+ * @brief Perfilador opcional de contenção para os mutexes dos monitores e dos filósofos
+ */
+
+#ifndef LOCK_PROFILER_H
+#define LOCK_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <pthread.h>
+#include "latency_histogram.h"
+
+/**
+ * @brief Trecho de código que segura o lock
+ */
+enum class LockSite {
+    PICKUP_FORKS,
+    RETURN_FORKS,
+    TEST_WITH_AGING,
+    GET_STATE,
+    SET_STATE,
+    STATS,
+    COUNT
+};
+
+/**
+ * @brief Nome de um LockSite para os relatórios
+ */
+inline const char* lockSiteName(LockSite site) {
+    switch (site) {
+        case LockSite::PICKUP_FORKS:    return "pickup_forks";
+        case LockSite::RETURN_FORKS:    return "return_forks";
+        case LockSite::TEST_WITH_AGING: return "testWithAging";
+        case LockSite::GET_STATE:       return "getState";
+        case LockSite::SET_STATE:       return "setState";
+        case LockSite::STATS:           return "estatísticas";
+        default:                        return "?";
+    }
+}
+
+/**
+ * @brief Estatísticas de um lock, separadas por trecho de código (tempos em ns)
+ */
+struct LockProfile {
+    struct SiteStats {
+        std::atomic<uint64_t> acquisitions{0}; ///< Aquisições feitas neste trecho
+        std::atomic<uint64_t> contended{0};    ///< Aquisições que encontraram o lock ocupado
+        LatencyHistogram wait;                 ///< Espera para adquirir (ns)
+        LatencyHistogram hold;                 ///< Tempo segurando o lock (ns)
+    };
+
+    std::string name;                                                  ///< Nome do lock
+    std::array<SiteStats, static_cast<size_t>(LockSite::COUNT)> sites; ///< Estatísticas por trecho
+
+    SiteStats& at(LockSite site) {
+        return sites[static_cast<size_t>(site)];
+    }
+};
+
+/**
+ * @brief Registro global dos perfis de lock
+ *
+ * Desativado por padrão; ativado pela variável de ambiente PHILOSOPHERS_LOCK_PROFILE=1
+ * ou por enable(). Desativado, cada lock custa apenas uma leitura atômica a mais.
+ * Perfis são agregados por nome (por exemplo, todos os Philosopher::stateMutex juntos).
+ */
+class LockProfiler {
+public:
+    static bool enabled() {
+        return flag().load(std::memory_order_relaxed);
+    }
+
+    static void enable() {
+        flag().store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Retorna o perfil com o nome dado, criando-o se necessário
+     */
+    static LockProfile* profile(const std::string& name) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        auto& entry = registry()[name];
+        if (!entry) {
+            entry = std::make_unique<LockProfile>();
+            entry->name = name;
+        }
+        return entry.get();
+    }
+
+    /**
+     * @brief Monta o relatório de todos os locks com histogramas de espera e de posse
+     */
+    static std::string report() {
+        static constexpr uint64_t limits[] = {1000, 10000, 100000, 1000000, 10000000};
+        static constexpr const char* labels[] = {"<1µs", "<10µs", "<100µs", "<1ms", "<10ms"};
+
+        std::string out = enabled() ? "" : "Perfilador de locks desativado.\n";
+        std::lock_guard<std::mutex> lock(registryMutex());
+        for (const auto& [name, profile] : registry()) {
+            out += std::format("{}\n", name);
+            for (size_t s = 0; s < profile->sites.size(); s++) {
+                const auto& stats = profile->sites[s];
+                uint64_t acquisitions = stats.acquisitions.load(std::memory_order_relaxed);
+                if (acquisitions == 0 && stats.hold.count() == 0) {
+                    continue;
+                }
+
+                uint64_t contended = stats.contended.load(std::memory_order_relaxed);
+                out += std::format("  {:<14} aquisições={} contendidas={} ({:.1f}%)\n",
+                                   lockSiteName(static_cast<LockSite>(s)), acquisitions, contended,
+                                   acquisitions > 0 ? 100.0 * contended / acquisitions : 0.0);
+
+                for (const auto* histogram : {&stats.wait, &stats.hold}) {
+                    out += std::format("    {} (ns) p50={} p99={} max={} |",
+                                       histogram == &stats.wait ? "espera" : "posse ",
+                                       histogram->percentile(50), histogram->percentile(99), histogram->max());
+                    uint64_t previous = 0;
+                    for (size_t b = 0; b < std::size(limits); b++) {
+                        uint64_t below = histogram->countAtMost(limits[b] - 1);
+                        out += std::format(" {}:{}", labels[b], below - previous);
+                        previous = below;
+                    }
+                    out += std::format(" >=10ms:{}\n", histogram->count() - previous);
+                }
+            }
+        }
+        return out;
+    }
+
+private:
+    static std::atomic<bool>& flag() {
+        static std::atomic<bool> value{[] {
+            const char* env = std::getenv("PHILOSOPHERS_LOCK_PROFILE");
+            return env != nullptr && std::string(env) == "1";
+        }()};
+        return value;
+    }
+
+    /**
+     * @brief Lock do registro; segurado durante o fork para que o filho o herde livre
+     */
+    static std::mutex& registryMutex() {
+        static std::mutex mutex;
+        static bool forkHandlers = [] {
+            pthread_atfork([] { mutex.lock(); }, [] { mutex.unlock(); }, [] { mutex.unlock(); });
+            return true;
+        }();
+        (void)forkHandlers;
+        return mutex;
+    }
+
+    static std::map<std::string, std::unique_ptr<LockProfile>>& registry() {
+        static std::map<std::string, std::unique_ptr<LockProfile>> profiles;
+        return profiles;
+    }
+};
+
+using LockClock = std::chrono::steady_clock;
+
+/**
+ * @brief Nanossegundos decorridos desde o instante dado
+ */
+inline uint64_t lockElapsedNs(LockClock::time_point since) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(LockClock::now() - since).count());
+}
+
+/**
+ * @brief Mutex POSIX do monitor com perfil de contenção
+ *
+ * Substitui as chamadas diretas a pthread_mutex_lock/unlock/pthread_cond_wait. O tempo
+ * em pthread_cond_wait não conta como posse.
+ */
+class ProfiledPthreadMutex {
+public:
+    explicit ProfiledPthreadMutex(const std::string& name) : profile(LockProfiler::profile(name)) {
+        pthread_mutex_init(&mutex, NULL);
+    }
+
+    ~ProfiledPthreadMutex() {
+        pthread_mutex_destroy(&mutex);
+    }
+
+    ProfiledPthreadMutex(const ProfiledPthreadMutex&) = delete;
+    ProfiledPthreadMutex& operator=(const ProfiledPthreadMutex&) = delete;
+
+    void lock(LockSite site) {
+        if (!LockProfiler::enabled()) {
+            pthread_mutex_lock(&mutex);
+            profiling = false;
+            return;
+        }
+
+        auto& stats = profile->at(site);
+        if (pthread_mutex_trylock(&mutex) == 0) {
+            stats.wait.record(0);
+        } else {
+            auto start = LockClock::now();
+            pthread_mutex_lock(&mutex);
+            stats.wait.record(lockElapsedNs(start));
+            stats.contended.fetch_add(1, std::memory_order_relaxed);
+        }
+        stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+
+        profiling = true;
+        holdSite = site;
+        holdStart = LockClock::now();
+    }
+
+    void unlock() {
+        endHold();
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * @brief pthread_cond_wait sobre este mutex, sem contar a espera como posse
+     */
+    void wait(pthread_cond_t* cond) {
+        LockSite site = holdSite;
+        bool wasProfiling = endHold();
+        pthread_cond_wait(cond, &mutex);
+        if (wasProfiling) {
+            profiling = true;
+            holdSite = site;
+            holdStart = LockClock::now();
+        }
+    }
+
+    /**
+     * @brief Registra como posse de outro trecho o tempo de um bloco executado com o lock
+     */
+    class SiteScope {
+    public:
+        SiteScope(ProfiledPthreadMutex& owner, LockSite site)
+            : stats(owner.profiling ? &owner.profile->at(site) : nullptr) {
+            if (stats) {
+                start = LockClock::now();
+            }
+        }
+
+        ~SiteScope() {
+            if (stats) {
+                stats->hold.record(lockElapsedNs(start));
+            }
+        }
+
+    private:
+        LockProfile::SiteStats* stats;
+        LockClock::time_point start;
+    };
+
+private:
+    pthread_mutex_t mutex;              ///< Mutex POSIX do monitor
+    LockProfile* profile;               ///< Perfil compartilhado pelos locks de mesmo nome
+    bool profiling = false;             ///< A posse atual está sendo medida (só o dono lê/escreve)
+    LockSite holdSite = LockSite::PICKUP_FORKS; ///< Trecho que adquiriu o lock
+    LockClock::time_point holdStart;     ///< Início da posse atual
+
+    bool endHold() {
+        if (!profiling) {
+            return false;
+        }
+        profile->at(holdSite).hold.record(lockElapsedNs(holdStart));
+        profiling = false;
+        return true;
+    }
+};
+
+/**
+ * @brief Equivalente a std::lock_guard com perfil de contenção
+ */
+template <typename Mutex>
+class ProfiledLockGuard {
+public:
+    ProfiledLockGuard(Mutex& mutex, LockProfile* profile, LockSite site)
+        : mutex(mutex), stats(LockProfiler::enabled() ? &profile->at(site) : nullptr) {
+        if (!stats) {
+            mutex.lock();
+            return;
+        }
+
+        if (mutex.try_lock()) {
+            stats->wait.record(0);
+        } else {
+            auto start = LockClock::now();
+            mutex.lock();
+            stats->wait.record(lockElapsedNs(start));
+            stats->contended.fetch_add(1, std::memory_order_relaxed);
+        }
+        stats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        holdStart = LockClock::now();
+    }
+
+    ~ProfiledLockGuard() {
+        if (stats) {
+            stats->hold.record(lockElapsedNs(holdStart));
+        }
+        mutex.unlock();
+    }
+
+    ProfiledLockGuard(const ProfiledLockGuard&) = delete;
+    ProfiledLockGuard& operator=(const ProfiledLockGuard&) = delete;
+
+private:
+    Mutex& mutex;
+    LockProfile::SiteStats* stats;
+    LockClock::time_point holdStart;
+};
+
+#endif // LOCK_PROFILER_H
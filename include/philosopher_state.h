@@ -0,0 +1,18 @@
+/**
+ * @file philosopher_state.h
+ * @brief Estados de um filósofo
+ */
+
+#ifndef PHILOSOPHER_STATE_H
+#define PHILOSOPHER_STATE_H
+
+/**
+ * @brief Estados possíveis de um filósofo
+ */
+enum class State {
+    THINKING,   ///< O filósofo está pensando
+    HUNGRY,     ///< O filósofo está com fome (tentando pegar os palitos)
+    EATING      ///< O filósofo está comendo
+};
+
+#endif // PHILOSOPHER_STATE_H
@@ -11,21 +11,20 @@
 #include <chrono>
 #include <thread>
 #include <random>
+#include <atomic>
+#include <cstdint>
 
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <format>
-
-/**
- * @brief Estados possíveis de um filósofo
- */
-enum class State {
-    THINKING,   ///< O filósofo está pensando
-    HUNGRY,     ///< O filósofo está com fome (tentando pegar os palitos)
-    EATING      ///< O filósofo está comendo
-};
+#include "lock_profiler.h"
+#include "event_channel.h"
+#include "philosopher_state.h"
+#include "table_snapshot.h"
+#include "safety_checker.h"
+#include "timer_wheel.h"
 
 /**
  * @brief Interface para um filósofo no problema dos Filósofos Jantantes
@@ -35,8 +34,12 @@ public:
     /**
      * @brief Construtor para um filósofo
      * @param id O identificador único para o filósofo
+     * @param events Canal de eventos da mesa
+     * @param board Quadro da mesa onde cada mudança é publicada
+     * @param checker Verificador das invariantes da mesa
+     * @param seat Posição do filósofo na mesa (0 a n-1)
      */
-    Philosopher(int id, int socketnum);
+    Philosopher(int id, EventChannel* events, SnapshotBoard* board, SafetyChecker* checker, int seat);
 
     /**
      * @brief Destrutor
@@ -61,6 +64,11 @@ public:
      */
     int getId() const;
 
+    /**
+     * @brief Obtém o número de refeições concluídas
+     */
+    uint64_t getMeals() const;
+
     /**
      * @brief Pega o palito esquerdo
      */
@@ -82,92 +90,163 @@ public:
     void putDownRightChopstick();
 
     /**
-     * @brief Faz o filósofo pensar por um tempo aleatório entre 1 e 3 segundos
+     * @brief Passa a publicar as mudanças em outro quadro (por exemplo, em memória compartilhada)
+     */
+    void setSnapshotBoard(SnapshotBoard* board);
+
+    /**
+     * @brief Passa a usar outro verificador (por exemplo, em memória compartilhada)
+     */
+    void setSafetyChecker(SafetyChecker* checker);
+
+    /**
+     * @brief Ajusta os tempos de pensar e comer (usado em benchmarks)
+     * @param thinkMinMs Tempo mínimo pensando (ms)
+     * @param thinkMaxMs Tempo máximo pensando (ms)
+     * @param eatMs Tempo comendo (ms)
+     */
+    void setTiming(int thinkMinMs, int thinkMaxMs, int eatMs);
+
+    /**
+     * @brief Faz o filósofo pensar por um tempo aleatório (padrão: entre 1 e 3 segundos)
      */
     void think();
 
     /**
-     * @brief Faz o filósofo comer por 3 segundos
+     * @brief Faz o filósofo comer (padrão: 3 segundos)
+     * O estado continua EATING até a mesa devolver os palitos ou o filósofo voltar a pensar
      */
     void eat();
 
 private:
-    int socketID;
+    EventChannel* events;       ///< Canal de eventos da mesa
+    std::string eventPrefix;    ///< Início pré-formatado dos eventos ("Filósofo <id> ")
+    SnapshotBoard* board;       ///< Quadro da mesa para observadores
+    SafetyChecker* checker;     ///< Verificador das invariantes da mesa
+    int seat;                   ///< Posição na mesa
 
     int id;                     ///< ID do filósofo
     State state;     ///< Estado atual do filósofo
     bool leftChopstick;         ///< Indica se o filósofo está segurando o palito esquerdo
     bool rightChopstick;        ///< Indica se o filósofo está segurando o palito direito
     mutable std::mutex stateMutex; ///< Mutex para proteger o acesso ao estado
+    LockProfile* stateProfile;     ///< Perfil de contenção do stateMutex (compartilhado por todos os filósofos)
+    int thinkMinMs = 1000;      ///< Tempo mínimo pensando (ms)
+    int thinkMaxMs = 3000;      ///< Tempo máximo pensando (ms)
+    int eatMs = 3000;           ///< Tempo comendo (ms)
+    std::atomic<uint64_t> meals{0}; ///< Refeições concluídas
 };
 
 // Implementação dos métodos
-inline Philosopher::Philosopher(int id, int socketnum)
-    : id(id), socketID(socketnum), state(State::THINKING), leftChopstick(false), rightChopstick(false) {
+inline Philosopher::Philosopher(int id, EventChannel* events, SnapshotBoard* board, SafetyChecker* checker, int seat)
+    : events(events), board(board), checker(checker), seat(seat), id(id), state(State::THINKING), leftChopstick(false), rightChopstick(false),
+      stateProfile(LockProfiler::profile("Philosopher::stateMutex")) {
+    eventPrefix = std::format("Filósofo {} ", id);
 }
 
 inline State Philosopher::getState() const {
-    std::lock_guard<std::mutex> lock(stateMutex);
+    ProfiledLockGuard<std::mutex> lock(stateMutex, stateProfile, LockSite::GET_STATE);
     return state;
 }
 
 inline void Philosopher::setState(State newState) {
-    std::lock_guard<std::mutex> lock(stateMutex);
+    ProfiledLockGuard<std::mutex> lock(stateMutex, stateProfile, LockSite::SET_STATE);
     state = newState;
+    board->publishState(seat, newState);
 }
 
 inline int Philosopher::getId() const {
     return id;
 }
 
+inline uint64_t Philosopher::getMeals() const {
+    return meals.load(std::memory_order_relaxed);
+}
+
+inline void Philosopher::setSnapshotBoard(SnapshotBoard* board) {
+    this->board = board;
+}
+
+inline void Philosopher::setSafetyChecker(SafetyChecker* checker) {
+    this->checker = checker;
+}
+
+inline void Philosopher::setTiming(int thinkMinMs, int thinkMaxMs, int eatMs) {
+    this->thinkMinMs = thinkMinMs;
+    this->thinkMaxMs = thinkMaxMs;
+    this->eatMs = eatMs;
+}
+
 inline void Philosopher::pickUpLeftChopstick() {
+    if (SafetyChecker::enabled()) {
+        checker->acquire(seat, seat);
+    }
     leftChopstick = true;
-    std::string msg = std::format("Filósofo {} pegou o palito esquerdo\n", id);
-    send(socketID, msg.c_str(), msg.size(), 0);
+    board->publishChopstick(seat, seat);
+    events->emit(eventPrefix, "pegou o palito esquerdo\n");
 }
 
 inline void Philosopher::pickUpRightChopstick() {
+    if (SafetyChecker::enabled()) {
+        checker->acquire(seat, checker->rightChopstickOf(seat));
+    }
     rightChopstick = true;
-    std::string msg = std::format("Filósofo {} pegou o palito direito\n", id);
-    send(socketID, msg.c_str(), msg.size(), 0);
+    board->publishChopstick(board->rightChopstickOf(seat), seat);
+    events->emit(eventPrefix, "pegou o palito direito\n");
 }
 
 inline void Philosopher::putDownLeftChopstick() {
     leftChopstick = false;
-    std::string msg = std::format("Filósofo {} soltou o palito esquerdo\n", id);
-    send(socketID, msg.c_str(), msg.size(), 0);
+    board->publishChopstick(seat, SnapshotBoard::NO_HOLDER);
+    if (SafetyChecker::enabled()) {
+        checker->release(seat, seat);
+    }
+    events->emit(eventPrefix, "soltou o palito esquerdo\n");
 }
 
 inline void Philosopher::putDownRightChopstick() {
     rightChopstick = false;
-    std::string msg = std::format("Filósofo {} soltou o palito direito\n", id);
-    send(socketID, msg.c_str(), msg.size(), 0);
+    board->publishChopstick(board->rightChopstickOf(seat), SnapshotBoard::NO_HOLDER);
+    if (SafetyChecker::enabled()) {
+        checker->release(seat, checker->rightChopstickOf(seat));
+    }
+    events->emit(eventPrefix, "soltou o palito direito\n");
 }
 
 inline void Philosopher::think() {
-    // Gera um tempo aleatório entre 1 e 3 segundos
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(1000, 3000); // 1-3 segundos em milissegundos
+    // As mesas sem monitor (semáforos, segmentos) não devolvem o estado ao soltar os palitos
+    setState(State::THINKING);
+
+    // Gera um tempo aleatório entre thinkMinMs e thinkMaxMs (padrão: 1-3 segundos);
+    // o gerador é semeado uma vez por thread
+    thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> distrib(thinkMinMs, thinkMaxMs);
     int thinkTime = distrib(gen);
     
-    std::string msg = std::format("Filósofo {} está pensando\n", id);
-    send(socketID, msg.c_str(), msg.size(), 0);
+    events->emit(eventPrefix, "está pensando\n");
     
     // Dorme pelo tempo gerado
-    std::this_thread::sleep_for(std::chrono::milliseconds(thinkTime));
+    TimerWheel::sleepFor(std::chrono::milliseconds(thinkTime));
     setState(State::HUNGRY);
 }
 
 inline void Philosopher::eat() {
     setState(State::EATING);
+    if (SafetyChecker::enabled()) {
+        checker->beginMeal(seat, leftChopstick && rightChopstick);
+    }
 
-    std::string msg = std::format("Filósofo {} está comendo\n", id);
-    send(socketID, msg.c_str(), msg.size(), 0);
+    events->emit(eventPrefix, "está comendo\n");
     
-    // Come por exatamente 3 segundos
-    std::this_thread::sleep_for(std::chrono::seconds(3));
-    setState(State::THINKING);
+    // Come por exatamente eatMs (padrão: 3 segundos)
+    TimerWheel::sleepFor(std::chrono::milliseconds(eatMs));
+    board->publishMeals(seat, meals.fetch_add(1, std::memory_order_relaxed) + 1);
+
+    // O estado só volta a THINKING quando os palitos forem devolvidos: antes disso um
+    // monitor poderia liberar um vizinho enquanto este filósofo ainda segura os palitos
+    if (SafetyChecker::enabled()) {
+        checker->endMeal(seat);
+    }
 }
 
 #endif // PHILOSOPHERS_H 
\ No newline at end of file
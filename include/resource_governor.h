@@ -0,0 +1,249 @@
+/**
+ * @file resource_governor.h
+ * @brief Orçamento global de threads e memória das mesas, com fila de admissão
+ */
+
+#ifndef RESOURCE_GOVERNOR_H
+#define RESOURCE_GOVERNOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <format>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include "latency_histogram.h"
+
+/**
+ * @brief Recursos pedidos por uma mesa e seu andamento na admissão
+ *
+ * Pertence à sessão que criou a mesa; o governador só guarda ponteiros para os
+ * tickets na fila, e todo acesso aos campos de estado é feito sob o lock dele.
+ */
+struct AdmissionTicket {
+    size_t threads = 0;          ///< Threads de filósofos pedidas
+    size_t bytes = 0;            ///< Memória estimada (pilhas e estruturas por filósofo)
+    bool queued = false;         ///< Aguardando na fila
+    bool admitted = false;       ///< Recursos reservados no orçamento
+    bool cancelled = false;      ///< A mesa foi parada antes de ser admitida
+    std::chrono::steady_clock::time_point enqueuedAt{};
+};
+
+/**
+ * @brief Governador de recursos do servidor, compartilhado por todas as sessões
+ *
+ * Uma mesa só começa depois de reservar suas threads e memória. Se não cabem no
+ * que sobra do orçamento, o pedido entra numa fila FIFO limitada e é admitido
+ * quando mesas anteriores liberam recursos; com a fila cheia, ou se a mesa sozinha
+ * excede o orçamento, é recusado na hora. A espera na fila também tem limite.
+ *
+ * Limites (variáveis de ambiente):
+ * - PHILOSOPHERS_MAX_THREADS: threads de filósofos no servidor (padrão 4096)
+ * - PHILOSOPHERS_MAX_MEMORY_MB: memória estimada das mesas em MiB (padrão: metade da RAM)
+ * - PHILOSOPHERS_MAX_QUEUE: mesas aguardando admissão (padrão 16)
+ * - PHILOSOPHERS_ADMISSION_TIMEOUT_S: espera máxima na fila em segundos (padrão 60)
+ */
+class ResourceGovernor {
+public:
+    /**
+     * @brief Resultado de um pedido de admissão
+     */
+    enum class Decision {
+        ADMITTED,    ///< Recursos reservados, a mesa pode começar
+        QUEUED,      ///< Na fila; chame waitForAdmission()
+        TOO_LARGE,   ///< A mesa sozinha excede o orçamento
+        QUEUE_FULL   ///< Sem recursos e sem vaga na fila
+    };
+
+    static ResourceGovernor& instance() {
+        static ResourceGovernor governor(envLimit("PHILOSOPHERS_MAX_THREADS", 4096),
+                                         envLimit("PHILOSOPHERS_MAX_MEMORY_MB", halfOfPhysicalMemoryMb()) << 20,
+                                         envLimit("PHILOSOPHERS_MAX_QUEUE", 16),
+                                         std::chrono::seconds(envLimit("PHILOSOPHERS_ADMISSION_TIMEOUT_S", 60)));
+        return governor;
+    }
+
+    ResourceGovernor(size_t maxThreads, size_t maxBytes, size_t maxQueue, std::chrono::milliseconds timeout)
+        : maxThreads(maxThreads), maxBytes(maxBytes), maxQueue(maxQueue), timeout(timeout) {}
+
+    ResourceGovernor(const ResourceGovernor&) = delete;
+    ResourceGovernor& operator=(const ResourceGovernor&) = delete;
+
+    /**
+     * @brief Reserva os recursos do ticket ou o coloca na fila
+     * @param position Posição na fila (1 = próximo), quando a decisão é QUEUED
+     */
+    Decision submit(AdmissionTicket& ticket, size_t* position = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ticket.threads > maxThreads || ticket.bytes > maxBytes) {
+            rejected++;
+            return Decision::TOO_LARGE;
+        }
+
+        // Ninguém fura a fila: só admite direto se não há quem espere
+        if (queue.empty() && fits(ticket)) {
+            reserve(ticket);
+            waits.record(0);
+            return Decision::ADMITTED;
+        }
+
+        if (queue.size() >= maxQueue) {
+            rejected++;
+            return Decision::QUEUE_FULL;
+        }
+
+        ticket.queued = true;
+        ticket.enqueuedAt = std::chrono::steady_clock::now();
+        queue.push_back(&ticket);
+        if (position) {
+            *position = queue.size();
+        }
+        return Decision::QUEUED;
+    }
+
+    /**
+     * @brief Aguarda a admissão de um ticket que está na fila
+     * @return true se admitido; false se cancelado ou se a espera passou do limite
+     */
+    bool waitForAdmission(AdmissionTicket& ticket) {
+        std::unique_lock<std::mutex> lock(mutex);
+        bool done = changed.wait_for(lock, timeout, [&] {
+            return ticket.admitted || ticket.cancelled;
+        });
+
+        if (ticket.admitted) {
+            return true;
+        }
+
+        // Sai da fila; quem estava atrás pode caber agora
+        std::erase(queue, &ticket);
+        ticket.queued = false;
+        if (!done) {
+            timedOut++;
+        }
+        admitWaiting();
+        return false;
+    }
+
+    /**
+     * @brief Desiste de um ticket que ainda está na fila (sem efeito se já admitido)
+     */
+    void cancel(AdmissionTicket& ticket) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ticket.queued) {
+            ticket.cancelled = true;
+            changed.notify_all();
+        }
+    }
+
+    /**
+     * @brief Devolve os recursos de uma mesa admitida que terminou
+     */
+    void release(AdmissionTicket& ticket) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ticket.admitted) {
+            return;
+        }
+        ticket.admitted = false;
+        usedThreads -= ticket.threads;
+        usedBytes -= ticket.bytes;
+        admitWaiting();
+    }
+
+    /**
+     * @brief Uso do orçamento, profundidade da fila e tempo de espera na admissão
+     */
+    std::string report() {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto oldest = queue.empty() ? std::chrono::milliseconds(0)
+                                    : std::chrono::duration_cast<std::chrono::milliseconds>(
+                                          std::chrono::steady_clock::now() - queue.front()->enqueuedAt);
+        return std::format("threads={}/{} memória={}/{}MiB fila={}/{} (mais antiga há {}ms) "
+                           "espera(ms) p50={} p99={} max={} admitidas={} recusadas={} expiradas={}\n",
+                           usedThreads, maxThreads, usedBytes >> 20, maxBytes >> 20, queue.size(), maxQueue,
+                           oldest.count(), waits.percentile(50), waits.percentile(99), waits.max(),
+                           waits.count(), rejected, timedOut);
+    }
+
+    size_t getMaxThreads() const {
+        return maxThreads;
+    }
+
+    size_t getMaxBytes() const {
+        return maxBytes;
+    }
+
+    size_t getMaxQueue() const {
+        return maxQueue;
+    }
+
+private:
+    const size_t maxThreads;
+    const size_t maxBytes;
+    const size_t maxQueue;
+    const std::chrono::milliseconds timeout;
+
+    std::mutex mutex;
+    std::condition_variable changed;       ///< Sinalizado quando tickets são admitidos ou cancelados
+    std::deque<AdmissionTicket*> queue;    ///< Tickets aguardando, em ordem de chegada
+    size_t usedThreads = 0;
+    size_t usedBytes = 0;
+    uint64_t rejected = 0;
+    uint64_t timedOut = 0;
+    LatencyHistogram waits;                ///< Espera até a admissão (ms), inclusive as imediatas
+
+    bool fits(const AdmissionTicket& ticket) const {
+        return usedThreads + ticket.threads <= maxThreads && usedBytes + ticket.bytes <= maxBytes;
+    }
+
+    void reserve(AdmissionTicket& ticket) {
+        usedThreads += ticket.threads;
+        usedBytes += ticket.bytes;
+        ticket.admitted = true;
+    }
+
+    /**
+     * @brief Admite, em ordem, os tickets do início da fila que cabem (chamar com o lock)
+     */
+    void admitWaiting() {
+        bool any = false;
+        while (!queue.empty() && fits(*queue.front())) {
+            AdmissionTicket* next = queue.front();
+            queue.pop_front();
+            next->queued = false;
+            reserve(*next);
+            waits.record(std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - next->enqueuedAt).count());
+            any = true;
+        }
+        if (any) {
+            changed.notify_all();
+        }
+    }
+
+    static size_t halfOfPhysicalMemoryMb() {
+        long pages = sysconf(_SC_PHYS_PAGES);
+        long pageSize = sysconf(_SC_PAGESIZE);
+        if (pages <= 0 || pageSize <= 0) {
+            return 4096;
+        }
+        return static_cast<size_t>(pages) / 2 * static_cast<size_t>(pageSize) >> 20;
+    }
+
+    static size_t envLimit(const char* name, size_t fallback) {
+        const char* env = std::getenv(name);
+        if (env == nullptr) {
+            return fallback;
+        }
+        char* end = nullptr;
+        unsigned long long value = std::strtoull(env, &end, 10);
+        return end != env && *end == '\0' && value > 0 ? static_cast<size_t>(value) : fallback;
+    }
+};
+
+#endif // RESOURCE_GOVERNOR_H
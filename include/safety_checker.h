@@ -0,0 +1,366 @@
+/**
+ * @file safety_checker.h
+ * @brief Verificador contínuo das invariantes de segurança da mesa
+ */
+
+#ifndef SAFETY_CHECKER_H
+#define SAFETY_CHECKER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "event_channel.h"
+
+/**
+ * @brief Verifica, a cada aquisição e liberação de palito, as invariantes da mesa
+ *
+ * - um palito tem no máximo um dono (palavra atômica por palito);
+ * - um filósofo só come segurando os dois palitos (e com as flags do Philosopher ligadas);
+ * - dois vizinhos nunca comem ao mesmo tempo.
+ *
+ * Não há lock nem contador global: cada verificação toca só as palavras dos palitos e
+ * dos vizinhos envolvidos, e o dono de um palito é conferido com load e store simples
+ * (uma posse sobreposta aparece na aquisição ou, se as duas correram juntas, na
+ * liberação de quem perdeu a palavra). Cada posição da mesa guarda seus eventos
+ * recentes em um anel próprio, escrito só pela thread do filósofo e carimbado com um
+ * relógio lógico (Lamport) do assento. O relógio viaja junto com o dono na palavra do
+ * palito, então quem pega um palito carimba depois de quem o soltou; em uma violação,
+ * os anéis são intercalados pelo carimbo (ordem causal) e enviados ao cliente e ao stderr.
+ *
+ * Ativado por padrão; PHILOSOPHERS_SAFETY_CHECK=0 desativa. Como o SnapshotBoard,
+ * tem layout fixo a partir do próprio endereço e pode viver em memória compartilhada.
+ */
+class alignas(64) SafetyChecker {
+public:
+    static constexpr int32_t NO_OWNER = -1;     ///< Palito livre
+    static constexpr size_t RING_SIZE = 64;     ///< Eventos guardados por filósofo (potência de 2)
+    static constexpr size_t DUMP_EVENTS = 48;   ///< Eventos mostrados em uma violação
+
+    /**
+     * @brief Tipos de evento registrados no anel
+     */
+    enum class Event : uint8_t {
+        PICKUP,
+        PUTDOWN,
+        MEAL_BEGIN,
+        MEAL_END,
+        VIOLATION
+    };
+
+    static bool enabled() {
+        return flag().load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool value) {
+        flag().store(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Bytes necessários para um verificador com numPhilosophers filósofos
+     */
+    static size_t bytesFor(size_t numPhilosophers) {
+        return sizeof(SafetyChecker) + numPhilosophers * sizeof(Seat);
+    }
+
+    /**
+     * @brief Constrói o verificador na memória dada (alinhada a 64 bytes, com bytesFor(n) bytes)
+     * @param events Canal onde as violações são relatadas
+     */
+    static SafetyChecker* create(void* memory, size_t numPhilosophers, EventChannel* events) {
+        auto* checker = new (memory) SafetyChecker(numPhilosophers, events);
+        for (size_t i = 0; i < numPhilosophers; i++) {
+            new (&checker->seat(i)) Seat();
+        }
+        return checker;
+    }
+
+    SafetyChecker(const SafetyChecker&) = delete;
+    SafetyChecker& operator=(const SafetyChecker&) = delete;
+
+    /**
+     * @brief O anel continua em outro segmento: o último filósofo não tem vizinho
+     * direito nem palito direito locais
+     */
+    void openRing() {
+        ringOpen = true;
+    }
+
+    /**
+     * @brief Índice do palito direito de um filósofo (-1 se não é local)
+     */
+    int rightChopstickOf(int seatIndex) const {
+        if (static_cast<size_t>(seatIndex) + 1 == numPhilosophers) {
+            return ringOpen ? NO_OWNER : 0;
+        }
+        return seatIndex + 1;
+    }
+
+    /**
+     * @brief Registra que o filósofo pegou o palito; o palito precisa estar livre
+     */
+    void acquire(int seatIndex, int chopstick) {
+        if (chopstick < 0) {
+            return;
+        }
+        std::atomic<uint64_t>& owner = seat(chopstick).owner;
+        uint64_t word = owner.load(std::memory_order_acquire);
+        Seat& mine = seat(seatIndex);
+        mine.clock = std::max(mine.clock, clockOf(word));
+        record(seatIndex, Event::PICKUP, chopstick);
+        owner.store(pack(seatIndex, mine.clock), std::memory_order_release);
+
+        int32_t previous = ownerOf(word);
+        if (previous != NO_OWNER) {
+            violation(seatIndex, chopstick,
+                      std::format("filósofo {} pegou o palito {}, que pertence ao filósofo {}",
+                                  seatIndex, chopstick, previous));
+        }
+    }
+
+    /**
+     * @brief Registra que o filósofo soltou o palito; o palito precisa ser dele
+     */
+    void release(int seatIndex, int chopstick) {
+        if (chopstick < 0) {
+            return;
+        }
+        record(seatIndex, Event::PUTDOWN, chopstick);
+
+        std::atomic<uint64_t>& owner = seat(chopstick).owner;
+        int32_t current = ownerOf(owner.load(std::memory_order_acquire));
+        if (current != seatIndex) {
+            violation(seatIndex, chopstick,
+                      std::format("filósofo {} soltou o palito {}, que pertence a {}", seatIndex, chopstick,
+                                  current == NO_OWNER ? std::string("ninguém")
+                                                      : std::format("filósofo {}", current)));
+            return;
+        }
+        owner.store(pack(NO_OWNER, seat(seatIndex).clock), std::memory_order_release);
+    }
+
+    /**
+     * @brief Início de uma refeição: confere os palitos e os vizinhos
+     * @param holdsBoth Flags leftChopstick e rightChopstick do Philosopher
+     */
+    void beginMeal(int seatIndex, bool holdsBoth) {
+        record(seatIndex, Event::MEAL_BEGIN, NO_OWNER);
+
+        int right = rightChopstickOf(seatIndex);
+        if (!holdsBoth ||
+            ownerOf(seat(seatIndex).owner.load(std::memory_order_acquire)) != seatIndex ||
+            (right >= 0 && ownerOf(seat(right).owner.load(std::memory_order_acquire)) != seatIndex)) {
+            violation(seatIndex, NO_OWNER,
+                      std::format("filósofo {} começou a comer sem segurar os dois palitos", seatIndex));
+        }
+
+        // Release/acquire bastam: dois vizinhos que começam juntos podem não ver a flag um
+        // do outro, mas os dois disputam o palito do meio e a palavra do dono já acusa isso
+        seat(seatIndex).eating.store(1, std::memory_order_release);
+        for (int neighbor : {leftNeighborOf(seatIndex), rightNeighborOf(seatIndex)}) {
+            if (neighbor >= 0 && neighbor != seatIndex &&
+                seat(neighbor).eating.load(std::memory_order_acquire) != 0) {
+                violation(seatIndex, NO_OWNER,
+                          std::format("filósofos vizinhos {} e {} comendo ao mesmo tempo", seatIndex, neighbor));
+            }
+        }
+    }
+
+    /**
+     * @brief Fim de uma refeição
+     */
+    void endMeal(int seatIndex) {
+        seat(seatIndex).eating.store(0, std::memory_order_release);
+        record(seatIndex, Event::MEAL_END, NO_OWNER);
+    }
+
+    /**
+     * @brief Devolve os palitos de um filósofo que deixou a mesa sem soltá-los
+     * (por exemplo, quando o processo trabalhador morreu)
+     */
+    void releaseSeat(int seatIndex) {
+        for (size_t i = 0; i < numPhilosophers; i++) {
+            uint64_t word = seat(i).owner.load(std::memory_order_acquire);
+            while (ownerOf(word) == seatIndex &&
+                   !seat(i).owner.compare_exchange_weak(word, pack(NO_OWNER, clockOf(word)),
+                                                        std::memory_order_acq_rel)) {
+            }
+        }
+        seat(seatIndex).eating.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Número de violações detectadas
+     */
+    uint64_t violations() const {
+        return violationCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Eventos recentes de todos os filósofos, em ordem causal
+     *
+     * Eventos ligados pela passagem de um palito aparecem na ordem em que ocorreram;
+     * os demais, intercalados pelo relógio lógico. Leitura sem lock: um evento
+     * sobrescrito durante a cópia pode aparecer fora de ordem.
+     */
+    std::string dumpRecentEvents(size_t maxEvents = DUMP_EVENTS) const {
+        struct Line {
+            uint64_t clock;
+            int seatIndex;
+            Event event;
+            int chopstick;
+        };
+
+        std::vector<Line> lines;
+        for (size_t s = 0; s < numPhilosophers; s++) {
+            const Seat& current = seat(s);
+            uint64_t head = current.head.load(std::memory_order_acquire);
+            uint64_t count = std::min<uint64_t>(head, RING_SIZE);
+            for (uint64_t k = head - count; k < head; k++) {
+                const Entry& entry = current.ring[k & (RING_SIZE - 1)];
+                uint64_t packed = entry.packed.load(std::memory_order_relaxed);
+                lines.push_back({packed >> 32, static_cast<int>(s), static_cast<Event>(packed & 0xff),
+                                 static_cast<int>((packed >> 8) & 0xffffff) - 1});
+            }
+        }
+
+        std::sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) {
+            return a.clock != b.clock ? a.clock < b.clock : a.seatIndex < b.seatIndex;
+        });
+        size_t start = lines.size() > maxEvents ? lines.size() - maxEvents : 0;
+
+        std::string out;
+        for (size_t i = start; i < lines.size(); i++) {
+            const Line& line = lines[i];
+            out += std::format("  [{:<8}] filósofo {:<3} {}", line.clock, line.seatIndex, eventName(line.event));
+            if (line.chopstick >= 0) {
+                out += std::format(" palito {}", line.chopstick);
+            }
+            out += '\n';
+        }
+        return out;
+    }
+
+private:
+    /**
+     * @brief Evento do anel em uma palavra: relógio:32 | (palito + 1):24 | tipo:8
+     *
+     * Uma única escrita por evento. O relógio tem os mesmos 32 bits que viajam na palavra
+     * do dono do palito; só daria a volta depois de 4 bilhões de eventos de um assento.
+     */
+    struct Entry {
+        std::atomic<uint64_t> packed{0};
+    };
+
+    /**
+     * @brief Dados de uma posição da mesa: dono do palito esquerdo, se está comendo
+     * e o anel de eventos do filósofo
+     *
+     * O dono do palito (disputado com o vizinho esquerdo) fica numa linha de cache
+     * separada das palavras escritas só pelo próprio filósofo; o alinhamento de 64
+     * bytes do verificador e de cada Seat garante as fronteiras.
+     */
+    struct alignas(64) Seat {
+        std::atomic<uint64_t> owner{pack(NO_OWNER, 0)}; ///< relógio:32 | dono:32 do palito desta posição
+        alignas(64) std::atomic<uint32_t> eating{0};    ///< O filósofo desta posição está comendo
+        std::atomic<uint64_t> head{0};                  ///< Eventos já escritos no anel
+        uint64_t clock = 0;                             ///< Relógio lógico do filósofo (só a thread dele usa)
+        alignas(64) Entry ring[RING_SIZE];              ///< Eventos recentes (escritos só pelo filósofo)
+    };
+
+    size_t numPhilosophers;                    ///< Filósofos na mesa
+    EventChannel* events;                      ///< Canal onde as violações são relatadas
+    bool ringOpen = false;                     ///< O anel continua em outro segmento
+    std::atomic<uint64_t> violationCount{0};   ///< Violações detectadas
+    std::atomic<bool> reported{false};         ///< O despejo dos eventos já foi feito
+
+    SafetyChecker(size_t numPhilosophers, EventChannel* events)
+        : numPhilosophers(numPhilosophers), events(events) {}
+
+    static std::atomic<bool>& flag() {
+        static std::atomic<bool> value{[] {
+            const char* env = std::getenv("PHILOSOPHERS_SAFETY_CHECK");
+            return env == nullptr || std::string(env) != "0";
+        }()};
+        return value;
+    }
+
+    static const char* eventName(Event event) {
+        switch (event) {
+            case Event::PICKUP:     return "pegou";
+            case Event::PUTDOWN:    return "soltou";
+            case Event::MEAL_BEGIN: return "começou a comer";
+            case Event::MEAL_END:   return "terminou de comer";
+            case Event::VIOLATION:  return "VIOLAÇÃO";
+            default:                return "?";
+        }
+    }
+
+    Seat& seat(size_t index) {
+        return reinterpret_cast<Seat*>(this + 1)[index];
+    }
+
+    const Seat& seat(size_t index) const {
+        return reinterpret_cast<const Seat*>(this + 1)[index];
+    }
+
+    int leftNeighborOf(int seatIndex) const {
+        if (seatIndex == 0) {
+            return ringOpen ? NO_OWNER : static_cast<int>(numPhilosophers) - 1;
+        }
+        return seatIndex - 1;
+    }
+
+    int rightNeighborOf(int seatIndex) const {
+        return rightChopstickOf(seatIndex);
+    }
+
+    static constexpr uint64_t pack(int32_t owner, uint64_t clock) {
+        return (clock << 32) | static_cast<uint32_t>(owner);
+    }
+
+    static int32_t ownerOf(uint64_t word) {
+        return static_cast<int32_t>(static_cast<uint32_t>(word));
+    }
+
+    static uint64_t clockOf(uint64_t word) {
+        return word >> 32;
+    }
+
+    /**
+     * @brief Avança o relógio do assento e guarda o evento no anel
+     */
+    void record(int seatIndex, Event event, int chopstick) {
+        Seat& current = seat(seatIndex);
+        uint64_t head = current.head.load(std::memory_order_relaxed);
+        Entry& entry = current.ring[head & (RING_SIZE - 1)];
+        entry.packed.store(((++current.clock & 0xffffffff) << 32) |
+                               (static_cast<uint64_t>(chopstick + 1) & 0xffffff) << 8 | static_cast<uint8_t>(event),
+                           std::memory_order_relaxed);
+        current.head.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Conta a violação; a primeira é relatada com os eventos recentes
+     */
+    void violation(int seatIndex, int chopstick, const std::string& description) {
+        record(seatIndex, Event::VIOLATION, chopstick);
+        violationCount.fetch_add(1, std::memory_order_relaxed);
+        if (reported.exchange(true)) {
+            return;
+        }
+
+        std::string report = std::format("VIOLAÇÃO DE SEGURANÇA: {}\nEventos recentes:\n{}",
+                                         description, dumpRecentEvents());
+        std::cerr << report;
+        events->send(report);
+    }
+};
+
+#endif // SAFETY_CHECKER_H
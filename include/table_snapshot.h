@@ -0,0 +1,239 @@
+/**
+ * @file table_snapshot.h
+ * @brief Quadro versionado (seqlock) com o estado da mesa para observadores
+ */
+
+#ifndef TABLE_SNAPSHOT_H
+#define TABLE_SNAPSHOT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <vector>
+#include "philosopher_state.h"
+
+/**
+ * @brief Cópia consistente da mesa em um instante
+ *
+ * Índices são posições na mesa (0 a n-1), não IDs globais dos filósofos.
+ */
+struct TableSnapshot {
+    uint64_t version = 0;               ///< Versão do quadro lida (cresce a cada mudança)
+    std::vector<State> states;          ///< Estado de cada filósofo
+    std::vector<uint64_t> meals;        ///< Refeições de cada filósofo
+    std::vector<int> chopstickHolders;  ///< Filósofo que segura cada palito (-1 se livre)
+    std::vector<uint64_t> collected[2]; ///< Coletas do leitor, reaproveitadas entre leituras
+};
+
+/**
+ * @brief Unidade de alocação alinhada a uma linha de cache
+ *
+ * Memória para o quadro e o verificador: new CacheLine[n] devolve blocos alinhados a
+ * 64 bytes, o que as estruturas por assento precisam para não dividir linhas.
+ */
+struct alignas(64) CacheLine {
+    unsigned char bytes[64];
+
+    /**
+     * @brief Linhas necessárias para guardar bytes bytes
+     */
+    static size_t countFor(size_t bytes) {
+        return (bytes + sizeof(CacheLine) - 1) / sizeof(CacheLine);
+    }
+};
+
+/**
+ * @brief Quadro com estados, refeições e donos dos palitos, lido sem lock por observadores
+ *
+ * Cada assento tem sua própria linha de cache (Slot e o quadro são alignas(64), e a
+ * memória precisa estar alinhada a 64 bytes) com três palavras atômicas: refeições,
+ * estado e dono do palito esquerdo (o palito com o mesmo índice do assento). Estado e
+ * dono levam um contador de versão na mesma palavra, e as refeições só crescem, então
+ * toda publicação muda o valor da palavra com uma única escrita. Não há lock de
+ * escritores: cada publicação só toca a palavra do próprio assento ou palito, e um
+ * processo que morra no meio de uma publicação não deixa nada pela metade.
+ *
+ * O leitor faz duas coletas seguidas de todas as palavras; se forem idênticas, houve um
+ * instante entre elas em que todos aqueles valores valiam ao mesmo tempo.
+ *
+ * O quadro tem layout fixo a partir do próprio endereço, por isso pode ser criado
+ * em memória compartilhada entre processos (ver create() e bytesFor()).
+ */
+class alignas(64) SnapshotBoard {
+public:
+    static constexpr int NO_HOLDER = -1; ///< Palito livre (ou fora deste segmento)
+
+    /**
+     * @brief Bytes necessários para um quadro com numPhilosophers filósofos
+     */
+    static size_t bytesFor(size_t numPhilosophers) {
+        return sizeof(SnapshotBoard) + numPhilosophers * sizeof(Slot);
+    }
+
+    /**
+     * @brief Constrói o quadro na memória dada (alinhada a 64 bytes, com bytesFor(n) bytes)
+     */
+    static SnapshotBoard* create(void* memory, size_t numPhilosophers) {
+        auto* board = new (memory) SnapshotBoard(numPhilosophers);
+        for (size_t i = 0; i < numPhilosophers; i++) {
+            new (&board->slot(i)) Slot();
+        }
+        return board;
+    }
+
+    SnapshotBoard(const SnapshotBoard&) = delete;
+    SnapshotBoard& operator=(const SnapshotBoard&) = delete;
+
+    size_t size() const {
+        return numPhilosophers;
+    }
+
+    /**
+     * @brief O palito direito do último filósofo pertence a outro segmento do anel
+     * e não é registrado neste quadro
+     */
+    void openRing() {
+        ringOpen = true;
+    }
+
+    /**
+     * @brief Índice do palito direito de um filósofo (-1 se não pertence ao quadro)
+     */
+    int rightChopstickOf(int seat) const {
+        if (static_cast<size_t>(seat) + 1 == numPhilosophers) {
+            return ringOpen ? NO_HOLDER : 0;
+        }
+        return seat + 1;
+    }
+
+    void publishState(int seat, State state) {
+        bump(slot(seat).state, STATE_BITS, static_cast<uint8_t>(state));
+    }
+
+    void publishMeals(int seat, uint64_t meals) {
+        slot(seat).meals.store(meals, std::memory_order_release);
+    }
+
+    void publishChopstick(int chopstick, int holder) {
+        if (chopstick < 0) {
+            return;
+        }
+        bump(slot(chopstick).holder, HOLDER_BITS, static_cast<uint32_t>(holder));
+    }
+
+    /**
+     * @brief Devolve o assento de um filósofo que deixou a mesa (processo morto): estado
+     * THINKING e livres os palitos que ainda constam como dele
+     */
+    void releaseSeat(int seat) {
+        publishState(seat, State::THINKING);
+        for (int chopstick : {seat, rightChopstickOf(seat)}) {
+            if (chopstick < 0) {
+                continue;
+            }
+            std::atomic<uint64_t>& word = slot(chopstick).holder;
+            uint64_t current = word.load(std::memory_order_relaxed);
+            while (static_cast<int32_t>(static_cast<uint32_t>(current)) == seat &&
+                   !word.compare_exchange_weak(current, next(current, HOLDER_BITS, static_cast<uint32_t>(NO_HOLDER)),
+                                               std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    /**
+     * @brief Copia o quadro de forma consistente, sem bloquear os escritores
+     * @param out Destino (os vetores são reaproveitados entre chamadas)
+     * @param maxAttempts Pares de coletas antes de desistir (com escritas contínuas em
+     * uma mesa grande, duas coletas seguidas podem nunca coincidir)
+     * @return false se nenhuma cópia consistente foi obtida
+     */
+    bool read(TableSnapshot& out, int maxAttempts = 1000) const {
+        std::vector<uint64_t>& first = out.collected[0];
+        std::vector<uint64_t>& second = out.collected[1];
+        collect(first);
+        for (int attempt = 0; attempt < maxAttempts; attempt++) {
+            collect(second);
+            if (first == second) {
+                decode(second, out);
+                return true;
+            }
+            first.swap(second);
+            if (attempt % 16 == 15) {
+                std::this_thread::yield();
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr int STATE_BITS = 8;   ///< Bits do estado na palavra; o resto é a versão
+    static constexpr int HOLDER_BITS = 32; ///< Bits do dono do palito na palavra; o resto é a versão
+
+    /**
+     * @brief Palavras de um assento, em uma linha de cache própria
+     */
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> meals{0};                                            ///< Refeições
+        std::atomic<uint64_t> state{static_cast<uint8_t>(State::THINKING)};        ///< versão:56 | estado:8
+        std::atomic<uint64_t> holder{static_cast<uint32_t>(NO_HOLDER)};            ///< versão:32 | dono:32
+    };
+
+    size_t numPhilosophers;                            ///< Filósofos no quadro
+    bool ringOpen = false;                             ///< O anel continua em outro segmento
+
+    explicit SnapshotBoard(size_t numPhilosophers) : numPhilosophers(numPhilosophers) {}
+
+    Slot& slot(size_t seat) const {
+        return reinterpret_cast<Slot*>(const_cast<SnapshotBoard*>(this) + 1)[seat];
+    }
+
+    /**
+     * @brief Troca o valor da palavra e incrementa sua versão
+     *
+     * Em geral só um escritor por vez toca cada palavra (o dono do assento ou do palito,
+     * ou quem tem o monitor); o CAS mantém a versão correta mesmo se isso não valer.
+     */
+    static void bump(std::atomic<uint64_t>& word, int valueBits, uint64_t value) {
+        uint64_t current = word.load(std::memory_order_relaxed);
+        while (!word.compare_exchange_weak(current, next(current, valueBits, value),
+                                           std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Palavra seguinte: versão incrementada e o novo valor
+     */
+    static uint64_t next(uint64_t current, int valueBits, uint64_t value) {
+        uint64_t mask = (uint64_t{1} << valueBits) - 1;
+        return (((current >> valueBits) + 1) << valueBits) | (value & mask);
+    }
+
+    void collect(std::vector<uint64_t>& words) const {
+        words.resize(3 * numPhilosophers);
+        for (size_t i = 0; i < numPhilosophers; i++) {
+            words[3 * i] = slot(i).meals.load(std::memory_order_acquire);
+            words[3 * i + 1] = slot(i).state.load(std::memory_order_acquire);
+            words[3 * i + 2] = slot(i).holder.load(std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Converte as palavras coletadas; a versão é o total de publicações
+     */
+    void decode(const std::vector<uint64_t>& words, TableSnapshot& out) const {
+        out.states.resize(numPhilosophers);
+        out.meals.resize(numPhilosophers);
+        out.chopstickHolders.resize(numPhilosophers);
+        out.version = 0;
+        for (size_t i = 0; i < numPhilosophers; i++) {
+            out.meals[i] = words[3 * i];
+            out.states[i] = static_cast<State>(words[3 * i + 1] & 0xff);
+            out.chopstickHolders[i] = static_cast<int32_t>(static_cast<uint32_t>(words[3 * i + 2]));
+            out.version += words[3 * i] + (words[3 * i + 1] >> STATE_BITS) + (words[3 * i + 2] >> HOLDER_BITS);
+        }
+    }
+};
+
+#endif // TABLE_SNAPSHOT_H
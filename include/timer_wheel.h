@@ -0,0 +1,479 @@
+/**
+ * @file timer_wheel.h
+ * @brief Roda de temporização hierárquica para as esperas de pensar e comer
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include "latency_histogram.h"
+
+/**
+ * @brief Roda de temporização com três níveis, movida por um único timerfd
+ *
+ * Em vez de cada filósofo dormir com sleep_for, a thread registra um prazo na roda e
+ * espera em uma palavra atômica (futex). Uma thread da roda dorme no timerfd, armado
+ * para o menor prazo pendente mais uma folga de 50 µs, e acorda de uma vez todas as
+ * threads vencidas até ali: prazos próximos custam um único despertar do timerfd.
+ * Ninguém acorda antes do prazo.
+ *
+ * Registrar uma espera não trava nada: a thread empilha o seu Timer (CAS) na caixa de
+ * entrada do núcleo em que está, uma por núcleo em linhas de cache separadas, e só
+ * reprograma o timerfd se o seu prazo vem antes do armado. Apenas a thread da roda
+ * mexe nos slots, esvaziando as caixas a cada despertar.
+ *
+ * Níveis: 256 slots de 1 ms, 64 de 256 ms e 64 de ~16 s; prazos mais distantes ficam
+ * no último nível e descem conforme o tempo passa. Os slots só organizam as esperas;
+ * o prazo de cada uma é guardado em ns. O atraso entre o prazo e o despertar (jitter)
+ * vai para um histograma em µs.
+ *
+ * Desativada por padrão: com esperas curtas e milhares de threads, a única thread da
+ * roda disputa a CPU com os filósofos e fica atrás de sleep_for (ver README).
+ * PHILOSOPHERS_TIMER_WHEEL=1 a ativa; nos dois modos o jitter é medido. Se o timerfd
+ * não puder ser criado, as esperas voltam a usar sleep_until. Há uma roda por processo: os processos trabalhadores da
+ * mesa em memória compartilhada chamam resetAfterFork().
+ */
+class TimerWheel {
+public:
+    static bool enabled() {
+        return flag().load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool value) {
+        flag().store(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Roda do processo (criada no primeiro uso)
+     */
+    static TimerWheel& instance() {
+        return *slot();
+    }
+
+    /**
+     * @brief Troca, no processo filho, a roda herdada por uma nova; a thread da roda do pai
+     * não existe após o fork
+     *
+     * Deve ser chamada logo após o fork, antes de criar threads. A roda herdada é destruída
+     * (fecha o timerfd): os handlers de pthread_atfork garantem que o lock dela chega livre
+     * ao filho, e as esperas que ela guardava são de threads do pai. Sem efeito se a roda
+     * não existia antes do fork.
+     */
+    static void resetAfterFork() {
+        if (!inherited()) {
+            return;
+        }
+        inherited() = false;
+        delete slot(); // Antes de criar a nova: o timerfd dela pode reusar o número do antigo
+        slot() = new TimerWheel();
+    }
+
+    /**
+     * @brief Dorme pelo tempo dado, pela roda ou por sleep_for, medindo o jitter
+     */
+    static void sleepFor(std::chrono::milliseconds duration) {
+        if (duration.count() <= 0) {
+            return;
+        }
+
+        auto deadline = Clock::now() + duration;
+        if (enabled()) {
+            instance().waitUntil(deadline);
+        } else {
+            std::this_thread::sleep_until(deadline);
+        }
+        jitter().record(elapsedUs(deadline));
+    }
+
+    /**
+     * @brief Atraso dos despertares em relação ao prazo (µs), de todas as esperas do processo
+     */
+    static LatencyHistogram& jitter() {
+        static LatencyHistogram histogram;
+        return histogram;
+    }
+
+    /**
+     * @brief Vezes que a thread da roda acordou do timerfd
+     */
+    uint64_t getTimerWakeups() const {
+        return timerWakeups.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Esperas concluídas pela roda
+     */
+    uint64_t getExpired() const {
+        return expired.load(std::memory_order_relaxed);
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int LEVEL0_BITS = 8;
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr uint64_t LEVEL0_SLOTS = 1 << LEVEL0_BITS;
+    static constexpr uint64_t LEVEL_SLOTS = 1 << LEVEL_BITS;
+    static constexpr uint64_t LEVEL1_SPAN = LEVEL0_SLOTS * LEVEL_SLOTS;   ///< Ticks cobertos pelos níveis 0 e 1
+    static constexpr uint64_t LEVEL2_SPAN = LEVEL1_SPAN * LEVEL_SLOTS;    ///< Ticks cobertos pelos três níveis
+    static constexpr uint64_t NS_PER_TICK = 1000000;                      ///< Tick de 1 ms
+    static constexpr uint64_t COALESCE_NS = 50000;                        ///< Folga para agrupar despertares próximos
+
+    /**
+     * @brief Uma espera registrada
+     *
+     * Cada thread usa sempre o mesmo Timer, que volta para uma lista de reuso quando a
+     * thread termina e nunca é liberado: um notify atrasado sempre cai em memória válida
+     * (no máximo acorda à toa o próximo dono, que volta a esperar).
+     */
+    struct Timer {
+        uint64_t deadlineNs = 0;         ///< Prazo em ns desde o início da roda
+        Timer* next = nullptr;
+        std::atomic<uint32_t> fired{0};  ///< 0 = esperando, 1 = acordado
+    };
+
+    /**
+     * @brief Timer da thread, devolvido à lista de reuso quando a thread termina
+     *
+     * A lista é uma pilha sem lock. Para não sofrer ABA, quem retira leva a pilha
+     * inteira (exchange), fica com o primeiro e devolve o resto; quem a encontra vazia
+     * nesse meio tempo aloca um Timer novo.
+     */
+    struct ThreadTimer {
+        Timer* timer;
+
+        ThreadTimer() {
+            timer = freeList().exchange(nullptr, std::memory_order_acquire);
+            if (timer == nullptr) {
+                timer = new Timer();
+                return;
+            }
+            if (timer->next) {
+                Timer* tail = timer->next;
+                while (tail->next) {
+                    tail = tail->next;
+                }
+                pushChain(freeList(), timer->next, tail);
+            }
+        }
+
+        ~ThreadTimer() {
+            pushChain(freeList(), timer, timer);
+        }
+    };
+
+    static std::atomic<Timer*>& freeList() {
+        static std::atomic<Timer*> head{nullptr};
+        return head;
+    }
+
+    /**
+     * @brief Empilha a cadeia first..last (ligada por next) em uma pilha sem lock
+     */
+    static void pushChain(std::atomic<Timer*>& head, Timer* first, Timer* last) {
+        Timer* top = head.load(std::memory_order_relaxed);
+        do {
+            last->next = top;
+        } while (!head.compare_exchange_weak(top, first, std::memory_order_seq_cst, std::memory_order_relaxed));
+    }
+
+    static constexpr int MAX_INBOXES = 64;
+
+    /**
+     * @brief Caixa de entrada de um núcleo: esperas registradas e ainda não postas nos slots
+     */
+    struct alignas(64) Inbox {
+        std::atomic<Timer*> head{nullptr};
+    };
+
+    Inbox inboxes[MAX_INBOXES];                    ///< Uma caixa por núcleo (as primeiras numInboxes)
+    int numInboxes;
+    std::atomic<uint64_t> armedNs{0};              ///< Instante pedido ao timerfd (0 = desarmado)
+    std::mutex armMutex;                           ///< Serializa só as chamadas a timerfd_settime
+
+    // Daqui em diante, só a thread da roda lê e escreve
+    Timer* level0[LEVEL0_SLOTS] = {};              ///< Slots de 1 ms
+    Timer* level1[LEVEL_SLOTS] = {};               ///< Slots de 256 ms
+    Timer* level2[LEVEL_SLOTS] = {};               ///< Slots de ~16 s
+    uint64_t currentTick = 0;                      ///< Tick atual (os anteriores já foram processados)
+    uint64_t pending = 0;                          ///< Esperas nos slots
+    Clock::time_point start;                       ///< Instante do tick 0
+    int timerFd;                                   ///< timerfd único da roda
+    std::atomic<uint64_t> timerWakeups{0};         ///< Leituras do timerfd
+    std::atomic<uint64_t> expired{0};              ///< Esperas concluídas
+
+    TimerWheel()
+        : numInboxes(std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, MAX_INBOXES)),
+          start(Clock::now()) {
+        timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (timerFd < 0) {
+            // Sem timerfd a roda não tem como acordar: as próximas esperas usam sleep_for, e
+            // as que já passaram por enabled() caem em sleep_until dentro de waitUntil
+            setEnabled(false);
+            return;
+        }
+        std::thread(&TimerWheel::loop, this).detach();
+    }
+
+    ~TimerWheel() {
+        if (timerFd >= 0) {
+            close(timerFd);
+        }
+    }
+
+    /**
+     * @brief Roda atual; no processo pai nunca é destruída, pois threads podem esperar até o fim
+     *
+     * Ao criá-la, registra handlers de fork que seguram armMutex durante o fork, para que
+     * nenhum filho herde o lock travado por uma thread que não existe nele.
+     */
+    static TimerWheel*& slot() {
+        static TimerWheel* wheel = [] {
+            pthread_atfork([] { slot()->armMutex.lock(); },
+                           [] { slot()->armMutex.unlock(); },
+                           [] {
+                               slot()->armMutex.unlock();
+                               inherited() = true;
+                           });
+            return new TimerWheel();
+        }();
+        return wheel;
+    }
+
+    /**
+     * @brief Indica que a roda atual veio do processo pai e ainda não foi trocada
+     */
+    static bool& inherited() {
+        static bool value = false;
+        return value;
+    }
+
+    static std::atomic<bool>& flag() {
+        static std::atomic<bool> value{[] {
+            const char* env = std::getenv("PHILOSOPHERS_TIMER_WHEEL");
+            return env != nullptr && std::string(env) == "1";
+        }()};
+        return value;
+    }
+
+    static uint64_t elapsedUs(Clock::time_point since) {
+        auto late = Clock::now() - since;
+        return late.count() > 0
+            ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(late).count())
+            : 0;
+    }
+
+    /**
+     * @brief Registra a espera e bloqueia até a thread da roda sinalizar
+     */
+    void waitUntil(Clock::time_point deadline) {
+        if (timerFd < 0) {
+            // Sem timerfd (por exemplo, EMFILE) ninguém acordaria a espera
+            std::this_thread::sleep_until(deadline);
+            return;
+        }
+
+        thread_local ThreadTimer threadTimer;
+        Timer& timer = *threadTimer.timer;
+        timer.fired.store(0, std::memory_order_relaxed);
+        timer.deadlineNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - start).count());
+
+        int cpu = sched_getcpu();
+        Inbox& inbox = inboxes[cpu > 0 ? cpu % numInboxes : 0];
+        pushChain(inbox.head, &timer, &timer);
+
+        // Antecipa o timerfd se o prazo vem antes do armado. O CAS vem depois do push
+        // (ambos seq_cst): ou a roda ainda vai esvaziar esta caixa depois de rearmar,
+        // ou este CAS enxerga o valor que ela deixou
+        uint64_t want = timer.deadlineNs + COALESCE_NS;
+        uint64_t armed = armedNs.load(std::memory_order_seq_cst);
+        while (armed == 0 || want < armed) {
+            if (armedNs.compare_exchange_weak(armed, want, std::memory_order_seq_cst)) {
+                program();
+                break;
+            }
+        }
+
+        while (timer.fired.load(std::memory_order_acquire) == 0) {
+            timer.fired.wait(0, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Coloca a espera no nível correspondente à distância até o tick do prazo
+     */
+    void insert(Timer* timer) {
+        uint64_t tick = std::max(timer->deadlineNs / NS_PER_TICK, currentTick);
+        uint64_t delta = tick - currentTick;
+        Timer** bucket;
+        if (delta < LEVEL0_SLOTS) {
+            bucket = &level0[tick & (LEVEL0_SLOTS - 1)];
+        } else if (delta < LEVEL1_SPAN) {
+            bucket = &level1[(tick >> LEVEL0_BITS) & (LEVEL_SLOTS - 1)];
+        } else {
+            // Além do alcance do nível 2, fica no slot mais distante e é reavaliado ao descer
+            if (delta >= LEVEL2_SPAN) {
+                tick = currentTick + LEVEL2_SPAN - 1;
+            }
+            bucket = &level2[(tick >> (LEVEL0_BITS + LEVEL_BITS)) & (LEVEL_SLOTS - 1)];
+        }
+        timer->next = *bucket;
+        *bucket = timer;
+    }
+
+    /**
+     * @brief Redistribui um slot de um nível superior pelos níveis inferiores
+     */
+    void cascade(Timer*& bucket) {
+        Timer* timer = bucket;
+        bucket = nullptr;
+        while (timer) {
+            Timer* next = timer->next;
+            insert(timer);
+            timer = next;
+        }
+    }
+
+    /**
+     * @brief Move para a lista de prontos as esperas vencidas do slot do tick atual
+     */
+    void expireCurrentSlot(uint64_t nowNs, Timer*& ready) {
+        Timer** link = &level0[currentTick & (LEVEL0_SLOTS - 1)];
+        while (*link) {
+            Timer* timer = *link;
+            if (timer->deadlineNs <= nowNs) {
+                *link = timer->next;
+                timer->next = ready;
+                ready = timer;
+                pending--;
+            } else {
+                link = &timer->next;
+            }
+        }
+    }
+
+    /**
+     * @brief Programa o timerfd com o valor atual de armedNs (ns desde o início da roda)
+     *
+     * Quem altera armedNs chama depois esta função; como ela relê o valor sob o lock,
+     * a última programação sempre usa o valor mais recente.
+     */
+    void program() {
+        std::lock_guard<std::mutex> lock(armMutex);
+        uint64_t whenNs = armedNs.load(std::memory_order_seq_cst);
+        itimerspec spec{};
+        if (whenNs != 0) {
+            auto when = start + std::chrono::nanoseconds(whenNs);
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+            spec.it_value.tv_sec = ns / 1000000000;
+            spec.it_value.tv_nsec = ns % 1000000000;
+        }
+        timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+
+    /**
+     * @brief Move para os slots as esperas de todas as caixas de entrada
+     * @return true se havia alguma
+     */
+    bool drainInboxes() {
+        bool any = false;
+        for (int i = 0; i < numInboxes; i++) {
+            Timer* timer = inboxes[i].head.exchange(nullptr, std::memory_order_seq_cst);
+            while (timer) {
+                Timer* next = timer->next;
+                insert(timer);
+                pending++;
+                timer = next;
+                any = true;
+            }
+        }
+        return any;
+    }
+
+    /**
+     * @brief Próximo instante com algo a fazer: o menor prazo do primeiro slot ocupado
+     * do nível 0 ou, se não houver, a próxima descida do nível 1
+     */
+    uint64_t nextWakeNs() const {
+        for (uint64_t tick = currentTick; tick < currentTick + LEVEL0_SLOTS; tick++) {
+            if (tick != currentTick && (tick & (LEVEL0_SLOTS - 1)) == 0) {
+                return tick * NS_PER_TICK;
+            }
+            uint64_t earliest = UINT64_MAX;
+            for (Timer* timer = level0[tick & (LEVEL0_SLOTS - 1)]; timer; timer = timer->next) {
+                earliest = std::min(earliest, timer->deadlineNs);
+            }
+            if (earliest != UINT64_MAX) {
+                return earliest + COALESCE_NS;
+            }
+        }
+        return ((currentTick | (LEVEL0_SLOTS - 1)) + 1) * NS_PER_TICK;
+    }
+
+    /**
+     * @brief Thread da roda: a cada despertar do timerfd, recolhe as caixas de entrada,
+     * processa os ticks vencidos, rearma e acorda as threads em lote
+     */
+    void loop() {
+        while (true) {
+            uint64_t expirations;
+            if (read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                continue;
+            }
+            timerWakeups.fetch_add(1, std::memory_order_relaxed);
+
+            Timer* ready = nullptr;
+            uint64_t nowNs = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+            drainInboxes();
+            expireCurrentSlot(nowNs, ready);
+            while (currentTick < nowNs / NS_PER_TICK) {
+                currentTick++;
+
+                // Ao completar uma volta de um nível, desce o slot atual do nível de cima
+                if ((currentTick & (LEVEL0_SLOTS - 1)) == 0) {
+                    if (((currentTick >> LEVEL0_BITS) & (LEVEL_SLOTS - 1)) == 0) {
+                        cascade(level2[(currentTick >> (LEVEL0_BITS + LEVEL_BITS)) & (LEVEL_SLOTS - 1)]);
+                    }
+                    cascade(level1[(currentTick >> LEVEL0_BITS) & (LEVEL_SLOTS - 1)]);
+                }
+                expireCurrentSlot(nowNs, ready);
+            }
+
+            // Rearma e só então confere as caixas: o que chegou antes disso entra no
+            // próximo prazo; o que chegar depois vê o novo armedNs e antecipa se preciso
+            do {
+                armedNs.store(pending > 0 ? nextWakeNs() : 0, std::memory_order_seq_cst);
+                program();
+            } while (drainInboxes());
+
+            // Acorda o lote; depois do store a thread acordada pode reusar o Timer
+            while (ready) {
+                Timer* timer = ready;
+                ready = timer->next;
+                timer->fired.store(1, std::memory_order_release);
+                timer->fired.notify_one();
+                expired.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+#endif // TIMER_WHEEL_H
@@ -5,78 +5,20 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <locale>
-#include "semaphore.cpp"
-#include "posix.cpp"
-#include "posix_aging.cpp"
+#include <cerrno>
+#include <cstring>
+#include "session.cpp"
+#include "partitioned.cpp"
 
 void* task(void* arg) {
     int* clientSocket = static_cast<int*>(arg);
 
-    bool running = true;
-    while(running) {
-
-        std::string msg =
-        "\n"
-        "######   ##   ##  #######           #####     ####    ##   ##   ####    ##   ##    ####            ######   ##   ##   ####    ####      #####    #####    #####   ######   ##   ##  #######  ######    #####\n"
-        "# ## #   ##   ##   ##   #            ## ##     ##     ###  ##    ##     ###  ##   ##  ##            ##  ##  ##   ##    ##      ##      ##   ##  ##   ##  ##   ##   ##  ##  ##   ##   ##   #   ##  ##  ##   ##\n"
-        "  ##     ##   ##   ## #              ##  ##    ##     #### ##    ##     #### ##  ##                 ##  ##  ##   ##    ##      ##      ##   ##  #        ##   ##   ##  ##  ##   ##   ## #     ##  ##  #\n"
-        "  ##     #######   ####              ##  ##    ##     ## ####    ##     ## ####  ##                 #####   #######    ##      ##      ##   ##   #####   ##   ##   #####   #######   ####     #####    #####\n"
-        "  ##     ##   ##   ## #              ##  ##    ##     ##  ###    ##     ##  ###  ##  ###            ##      ##   ##    ##      ##   #  ##   ##       ##  ##   ##   ##      ##   ##   ## #     ## ##        ##\n"
-        "  ##     ##   ##   ##   #            ## ##     ##     ##   ##    ##     ##   ##   ##  ##            ##      ##   ##    ##      ##  ##  ##   ##  ##   ##  ##   ##   ##      ##   ##   ##   #   ##  ##  ##   ##\n"
-        " ####    ##   ##  #######           #####     ####    ##   ##   ####    ##   ##    #####           ####     ##   ##   ####    #######   #####    #####    #####   ####     ##   ##  #######  #### ##   #####\n\n"
-        "1. Método por Semáforo\n"
-        "2. Método com monitores POSIX\n"
-        "3. Método com monitores POSIX e Aging (Anti-Starvation)\n"
-        "4. Sair\n"
-        "Escolha uma opção: ";
-        send(*clientSocket, msg.c_str(), msg.size(), 0);
-
-        char buffer[1024] = {0};
-        int bytesReceived = recv(*clientSocket, buffer, sizeof(buffer), 0);
-
-        std::string message(buffer, bytesReceived);
-        int option = std::stoi(message);
-
-        switch (option) {
-            case 1:
-                // Método por Semáforo
-                {
-                    SemaphoreDiningTable table(5, *clientSocket);
-                    table.run(); // A execução continuará indefinidamente até ser interrompida
-                }
-                break;
-            case 2:
-                // Método com monitores POSIX
-                {
-                    PosixDiningTable table(5, *clientSocket);
-                    table.run(); // A execução continuará indefinidamente até ser interrompida
-                }
-                break;
-            
-            case 3:
-                // Método com monitores POSIX com mecanismo de Aging
-                {
-                    PosixAgingDiningTable table(5, *clientSocket);
-                    table.run(); // A execução continuará indefinidamente até ser interrompida
-                }
-                break;
-            
-            case 4:
-                msg = "Saindo do programa...\n";
-                send(*clientSocket, msg.c_str(), msg.size(), 0);
-
-                running = false;
-                break;
-
-            default:
-                msg = "Opção inválida. Por favor, selecione uma opção entre 1 e 4.\n";
-                send(*clientSocket, msg.c_str(), msg.size(), 0);
-
-                option = 0;
-                break;
-        }
-
+    // A sessão interpreta os comandos do cliente e mantém as mesas em execução
+    {
+        Session session(*clientSocket);
+        session.run();
     }
+
     close(*clientSocket);
     delete clientSocket;
     pthread_exit(nullptr);
@@ -119,38 +61,73 @@ public:
     }
 
     void start() {
-        // iniciando socket listenig, permitindo até 10 conexões
+        // iniciando socket listenig, com até LIMIT conexões pendentes
         if (listen(serverSocket, LIMIT) < 0) {
             std::cerr << "Listening erro" << std::endl;
             close(serverSocket);
             exit(-1);
         }
 
-        pthread_t threads[LIMIT];
-
-        for (int i = 0; i < LIMIT; ++i) {
+        // Aceita conexões indefinidamente; falhas de uma conexão não derrubam o servidor
+        while (true) {
             int* clientSocket = new int; // aloca espaço para cada socket
             *clientSocket = accept(serverSocket, (struct sockaddr*)&address, (socklen_t*)&addrlen);
 
             if (*clientSocket < 0) {
-                std::cerr << "Accept erro " << std::endl;
-                close(serverSocket);
-                exit(-1);
+                std::cerr << "Accept erro: " << std::strerror(errno) << std::endl;
+                delete clientSocket;
+                // Sem descritores livres: espera alguma sessão terminar antes de tentar de novo
+                if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                    sleep(1);
+                }
+                continue;
             }
 
-            if (pthread_create(&threads[i], nullptr, task, (void*)clientSocket) != 0) {
-                std::cerr << "Thread create erro " << std::endl;
+            pthread_t thread;
+            int error = pthread_create(&thread, nullptr, task, (void*)clientSocket);
+            if (error != 0) {
+                std::cerr << "Thread create erro: " << std::strerror(error) << std::endl;
+                const char* msg = "erro: servidor sem recursos para novas sessões, tente mais tarde\n";
+                send(*clientSocket, msg, std::strlen(msg), MSG_NOSIGNAL);
+                close(*clientSocket);
                 delete clientSocket;
-                exit(-1);
+                continue;
             }
+            pthread_detach(thread);
         }
     }
 
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     // Configurar locale para exibir caracteres acentuados corretamente
     std::setlocale(LC_ALL, "pt_BR.UTF-8");
+
+    // Com o perfilador de locks ativo, imprime o relatório ao encerrar
+    std::atexit([] {
+        if (LockProfiler::enabled()) {
+            std::cerr << LockProfiler::report();
+        }
+    });
+
+    // Modo segmento: esta instância executa uma parte de um anel dividido entre processos
+    // ./philosophers --partition <segmento> <segmentos> <filósofos> <porta-base>
+    if (argc == 6 && std::string(argv[1]) == "--partition") {
+        int segment = std::atoi(argv[2]);
+        int numSegments = std::atoi(argv[3]);
+        int totalPhilosophers = std::atoi(argv[4]);
+        int basePort = std::atoi(argv[5]);
+
+        if (numSegments < 1 || segment < 0 || segment >= numSegments || totalPhilosophers < 2 * numSegments) {
+            std::cerr << "Parâmetros inválidos: é preciso 0 <= segmento < segmentos e "
+                         "pelo menos 2 filósofos por segmento" << std::endl;
+            return 1;
+        }
+
+        PartitionedDiningTable table(segment, numSegments, totalPhilosophers, basePort, -1);
+        table.run();
+        return 0;
+    }
     
     Server server;
     server.start(); 
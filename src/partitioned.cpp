@@ -0,0 +1,633 @@
+#include "../include/dining_table.h"
+#include "../include/latency_histogram.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <netinet/tcp.h>
+
+/**
+ * @brief Mensagens do protocolo entre segmentos de um anel particionado
+ *
+ * Cada mensagem ocupa 9 bytes: tipo (1 byte), palito (4 bytes) e sequência
+ * (4 bytes), inteiros em ordem de rede.
+ */
+struct PartitionMessage {
+    enum Type : uint8_t {
+        REQUEST = 1, ///< Pede o palito ao dono
+        GRANT = 2,   ///< O dono concede o palito
+        RELEASE = 3  ///< Devolve o palito ao dono
+    };
+
+    static constexpr size_t WIRE_SIZE = 9;
+
+    uint8_t type;
+    uint32_t chopstick;
+    uint32_t seq;
+
+    void encode(char* out) const {
+        uint32_t c = htonl(chopstick);
+        uint32_t s = htonl(seq);
+        out[0] = static_cast<char>(type);
+        std::memcpy(out + 1, &c, sizeof(c));
+        std::memcpy(out + 5, &s, sizeof(s));
+    }
+
+    static PartitionMessage decode(const char* in) {
+        uint32_t c, s;
+        std::memcpy(&c, in + 1, sizeof(c));
+        std::memcpy(&s, in + 5, sizeof(s));
+        return {static_cast<uint8_t>(in[0]), ntohl(c), ntohl(s)};
+    }
+};
+
+/**
+ * @brief Conexão com um segmento vizinho, com envio em lote e estatísticas
+ *
+ * As mensagens enfileiradas são acumuladas e enviadas por uma thread dedicada
+ * em um único send(); uma segunda thread lê e despacha as mensagens recebidas.
+ */
+class PeerLink {
+public:
+    /**
+     * @brief Construtor
+     * @param name Nome do enlace usado nos relatórios
+     * @param fd Socket já conectado
+     * @param onMessage Função chamada para cada mensagem recebida
+     * @param onClose Função chamada pela thread de leitura quando a conexão termina (EOF ou erro)
+     */
+    PeerLink(std::string name, int fd, std::function<void(const PartitionMessage&)> onMessage,
+             std::function<void()> onClose)
+        : name(std::move(name)), fd(fd), onMessage(std::move(onMessage)), onClose(std::move(onClose)) {
+        int opt = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    }
+
+    /**
+     * @brief Inicia as threads de envio e leitura
+     */
+    void start() {
+        sender = std::thread(&PeerLink::senderLoop, this);
+        reader = std::thread(&PeerLink::readerLoop, this);
+    }
+
+    /**
+     * @brief Destrutor: encerra as threads e fecha o socket
+     */
+    ~PeerLink() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            closing = true;
+        }
+        queueCond.notify_one();
+        shutdown(fd, SHUT_RDWR);
+        if (sender.joinable()) {
+            sender.join();
+        }
+        if (reader.joinable()) {
+            reader.join();
+        }
+        close(fd);
+    }
+
+    /**
+     * @brief Enfileira uma mensagem para o próximo lote
+     */
+    void post(const PartitionMessage& message) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            pending.push_back(message);
+        }
+        queueCond.notify_one();
+    }
+
+    /**
+     * @brief Indica se o vizinho fechou a conexão
+     */
+    bool isClosed() const {
+        return peerClosed;
+    }
+
+    /**
+     * @brief Histograma da latência pedido→concessão dos palitos remotos (µs)
+     */
+    LatencyHistogram& roundTrip() {
+        return roundTripHistogram;
+    }
+
+    /**
+     * @brief Retorna um resumo das estatísticas do enlace
+     */
+    std::string report() const {
+        uint64_t batches = batchesSent.load();
+        return std::format("{}: enviadas={} recebidas={} lotes={} msgs/lote={:.2f} bytes={} "
+                           "rtt(µs) p50={} p99={} max={}",
+                           name, messagesSent.load(), messagesReceived.load(), batches,
+                           batches > 0 ? static_cast<double>(messagesSent.load()) / batches : 0.0,
+                           messagesSent.load() * PartitionMessage::WIRE_SIZE,
+                           roundTripHistogram.percentile(50), roundTripHistogram.percentile(99),
+                           roundTripHistogram.max());
+    }
+
+private:
+    std::string name;                                     ///< Nome do enlace
+    int fd;                                               ///< Socket conectado ao vizinho
+    std::function<void(const PartitionMessage&)> onMessage; ///< Despacho das mensagens recebidas
+    std::function<void()> onClose;                        ///< Aviso de conexão encerrada
+    std::mutex queueMutex;                                ///< Protege a fila de envio
+    std::condition_variable queueCond;                    ///< Acorda a thread de envio
+    std::vector<PartitionMessage> pending;                ///< Mensagens aguardando o próximo lote
+    bool closing = false;                                 ///< Pedido de encerramento
+    std::atomic<bool> peerClosed{false};                  ///< O vizinho fechou a conexão
+    std::atomic<uint64_t> messagesSent{0};                ///< Mensagens enviadas
+    std::atomic<uint64_t> messagesReceived{0};            ///< Mensagens recebidas
+    std::atomic<uint64_t> batchesSent{0};                 ///< Chamadas a send()
+    LatencyHistogram roundTripHistogram;                  ///< Latência pedido→concessão (µs)
+    std::thread sender;                                   ///< Thread de envio em lote
+    std::thread reader;                                   ///< Thread de leitura
+
+    void senderLoop() {
+        std::vector<PartitionMessage> batch;
+        std::vector<char> buffer;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCond.wait(lock, [this] { return closing || !pending.empty(); });
+                if (closing) {
+                    return;
+                }
+                batch.swap(pending);
+            }
+
+            // Codifica o lote inteiro e envia em uma única chamada
+            buffer.resize(batch.size() * PartitionMessage::WIRE_SIZE);
+            for (size_t i = 0; i < batch.size(); i++) {
+                batch[i].encode(buffer.data() + i * PartitionMessage::WIRE_SIZE);
+            }
+
+            size_t offset = 0;
+            while (offset < buffer.size()) {
+                ssize_t sent = send(fd, buffer.data() + offset, buffer.size() - offset, MSG_NOSIGNAL);
+                if (sent <= 0) {
+                    return;
+                }
+                offset += sent;
+            }
+
+            messagesSent += batch.size();
+            batchesSent++;
+            batch.clear();
+        }
+    }
+
+    void readerLoop() {
+        char buffer[4096];
+        size_t filled = 0;
+
+        while (true) {
+            ssize_t received = recv(fd, buffer + filled, sizeof(buffer) - filled, 0);
+            if (received <= 0) {
+                peerClosed = true;
+                onClose();
+                return;
+            }
+            filled += received;
+
+            // Despacha todas as mensagens completas do buffer
+            size_t offset = 0;
+            while (filled - offset >= PartitionMessage::WIRE_SIZE) {
+                onMessage(PartitionMessage::decode(buffer + offset));
+                messagesReceived++;
+                offset += PartitionMessage::WIRE_SIZE;
+            }
+            std::memmove(buffer, buffer + offset, filled - offset);
+            filled -= offset;
+        }
+    }
+};
+
+/**
+ * @brief Palito pertencente a este segmento, disputado por filósofos locais e pelo vizinho
+ */
+class PartitionChopstick {
+public:
+    /**
+     * @brief Pega o palito para um filósofo local (bloqueante)
+     * @param running Flag da mesa: a espera termina sem o palito quando ela vira false
+     * @return true se o palito foi pego
+     */
+    bool acquire(const std::atomic<bool>& running) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&] { return !held || !running; });
+        if (held) {
+            return false;
+        }
+        held = true;
+        return true;
+    }
+
+    /**
+     * @brief Acorda os filósofos esperando o palito para que revejam a flag da mesa
+     */
+    void wakeAll() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        cond.notify_all();
+    }
+
+    /**
+     * @brief Solta o palito de um filósofo local
+     * @param grantRemote Chamada com a sequência do pedido se o vizinho estava esperando:
+     * o palito passa direto para ele
+     */
+    void release(const std::function<void(uint32_t)>& grantRemote) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (remoteWaiting) {
+            remoteWaiting = false;
+            remoteHolds = true;
+            uint32_t seq = remoteSeq;
+            lock.unlock();
+            grantRemote(seq);
+            return;
+        }
+        held = false;
+        lock.unlock();
+        cond.notify_one();
+    }
+
+    /**
+     * @brief Trata um pedido do vizinho
+     * @param seq Sequência do pedido, guardada junto com a espera para a concessão posterior
+     * @return true se o palito foi concedido imediatamente
+     */
+    bool requestRemote(uint32_t seq) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (held) {
+            remoteWaiting = true;
+            remoteSeq = seq;
+            return false;
+        }
+        held = true;
+        remoteHolds = true;
+        return true;
+    }
+
+    /**
+     * @brief Trata a devolução do palito pelo vizinho
+     */
+    void releaseRemote() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!remoteHolds) {
+                return;
+            }
+            remoteHolds = false;
+            held = false;
+        }
+        cond.notify_one();
+    }
+
+    /**
+     * @brief O vizinho desconectou: recupera o palito concedido a ele e esquece seu pedido
+     */
+    void abortRemote() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            remoteWaiting = false;
+            if (remoteHolds) {
+                remoteHolds = false;
+                held = false;
+            }
+        }
+        cond.notify_all();
+    }
+
+private:
+    std::mutex mutex;                ///< Protege o estado do palito
+    std::condition_variable cond;    ///< Acorda filósofos locais esperando o palito
+    bool held = false;               ///< O palito está em uso (local ou remoto)
+    bool remoteWaiting = false;      ///< O vizinho pediu o palito e aguarda
+    bool remoteHolds = false;        ///< O palito foi concedido ao vizinho
+    uint32_t remoteSeq = 0;          ///< Sequência do pedido do vizinho em espera
+};
+
+/**
+ * @brief Segmento contíguo de um anel de filósofos distribuído entre várias instâncias
+ *
+ * A instância k de S possui os filósofos e os palitos [k*N/S, (k+1)*N/S). O palito c
+ * fica à esquerda do filósofo c, então só o último filósofo do segmento precisa de
+ * um palito remoto (o primeiro do segmento seguinte). Todos pegam primeiro o palito
+ * de menor número (hierarquia de recursos), o que evita deadlock no anel inteiro.
+ *
+ * A instância k escuta em basePort + k (pedidos do segmento anterior) e conecta em
+ * basePort + (k + 1) % S (para pedir o palito do segmento seguinte).
+ */
+class PartitionedDiningTable : public DiningTable {
+public:
+    /**
+     * @brief Construtor para um segmento do anel
+     * @param segment Índice deste segmento (0 a numSegments-1)
+     * @param numSegments Número de instâncias que dividem o anel
+     * @param totalPhilosophers Número de filósofos no anel inteiro
+     * @param basePort Porta TCP do segmento 0; o segmento k usa basePort + k
+     */
+    PartitionedDiningTable(int segment, int numSegments, int totalPhilosophers, int basePort, int socketnum)
+        : DiningTable(segmentEnd(segment, numSegments, totalPhilosophers) - segmentBegin(segment, numSegments, totalPhilosophers),
+                      socketnum, segmentBegin(segment, numSegments, totalPhilosophers)),
+          segment(segment),
+          numSegments(numSegments),
+          totalPhilosophers(totalPhilosophers),
+          basePort(basePort),
+          first(segmentBegin(segment, numSegments, totalPhilosophers)) {
+        // O palito direito do último filósofo local pertence ao próximo segmento
+        if (numSegments > 1) {
+            snapshotBoard->openRing();
+            safetyChecker->openRing();
+        }
+
+        localChopsticks.resize(philosophers.size());
+        for (auto& chopstick : localChopsticks) {
+            chopstick = std::make_unique<PartitionChopstick>();
+        }
+    }
+
+    /**
+     * @brief Conecta aos segmentos vizinhos e executa a simulação do segmento
+     */
+    void run() override {
+        std::cout << std::format("Segmento {}/{}: filósofos [{}, {}) de {}\n", segment, numSegments,
+                                 first, first + philosophers.size(), totalPhilosophers);
+
+        if (numSegments > 1 && !connectPeers()) {
+            return;
+        }
+
+        // Cria uma thread para cada filósofo do segmento
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < philosophers.size(); i++) {
+            threads.emplace_back(&PartitionedDiningTable::philosopherLifecycle, this, static_cast<int>(i));
+        }
+
+        // Relata as estatísticas dos enlaces a cada 5 segundos
+        auto start = std::chrono::steady_clock::now();
+        auto lastReport = start;
+        while (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+            if ((previousLink && previousLink->isClosed()) || (nextLink && nextLink->isClosed())) {
+                std::cout << "Um segmento vizinho desconectou; encerrando.\n";
+                running = false;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastReport >= std::chrono::seconds(5)) {
+                printReport(now - start);
+                lastReport = now;
+            }
+        }
+
+        // Acorda quem espera um palito, local ou remoto, para que veja o encerramento
+        for (auto& chopstick : localChopsticks) {
+            chopstick->wakeAll();
+        }
+        remoteGranted.store(true);
+        remoteGranted.notify_all();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        printReport(std::chrono::steady_clock::now() - start);
+        nextLink.reset();
+        previousLink.reset();
+    }
+
+    /**
+     * @brief Retorna o número de refeições concluídas neste segmento
+     */
+    uint64_t getMeals() const {
+        return meals.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Primeiro filósofo do segmento
+     */
+    static int segmentBegin(int segment, int numSegments, int totalPhilosophers) {
+        return static_cast<int>(static_cast<long long>(segment) * totalPhilosophers / numSegments);
+    }
+
+    /**
+     * @brief Um após o último filósofo do segmento
+     */
+    static int segmentEnd(int segment, int numSegments, int totalPhilosophers) {
+        return segmentBegin(segment + 1, numSegments, totalPhilosophers);
+    }
+
+private:
+    std::atomic<uint64_t> meals{0};    ///< Refeições concluídas neste segmento
+    int segment;                       ///< Índice deste segmento
+    int numSegments;                   ///< Número de segmentos do anel
+    int totalPhilosophers;             ///< Filósofos no anel inteiro
+    int basePort;                      ///< Porta do segmento 0
+    int first;                         ///< ID global do primeiro filósofo/palito do segmento
+    std::vector<std::unique_ptr<PartitionChopstick>> localChopsticks; ///< Palitos [first, first + n)
+    std::unique_ptr<PeerLink> previousLink; ///< Enlace com o segmento anterior (servimos o palito first)
+    std::unique_ptr<PeerLink> nextLink;     ///< Enlace com o segmento seguinte (pedimos o palito dele)
+    std::atomic<bool> remoteGranted{false}; ///< O palito remoto foi concedido
+    std::atomic<std::chrono::steady_clock::rep> requestedAt{0}; ///< Instante do último pedido remoto
+    std::atomic<uint32_t> requestSeq{0};      ///< Sequência do último pedido feito ao segmento seguinte
+
+    /**
+     * @brief Estabelece os enlaces com os segmentos anterior e seguinte
+     * @return true se os dois enlaces foram estabelecidos
+     */
+    bool connectPeers() {
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        int opt = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(basePort + segment);
+
+        if (bind(listener, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 1) < 0) {
+            std::cerr << "Segmento: erro ao escutar na porta " << basePort + segment << ": "
+                      << std::strerror(errno) << std::endl;
+            close(listener);
+            return false;
+        }
+
+        // Conecta ao segmento seguinte, tentando até que ele esteja no ar
+        int nextPort = basePort + (segment + 1) % numSegments;
+        int nextFd = -1;
+        std::thread connector([&] {
+            address.sin_port = htons(nextPort);
+            while (running) {
+                nextFd = socket(AF_INET, SOCK_STREAM, 0);
+                if (connect(nextFd, (struct sockaddr*)&address, sizeof(address)) == 0) {
+                    return;
+                }
+                close(nextFd);
+                nextFd = -1;
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+        });
+
+        int previousFd = accept(listener, nullptr, nullptr);
+        connector.join();
+        close(listener);
+
+        if (previousFd < 0 || nextFd < 0) {
+            std::cerr << "Segmento: erro ao conectar aos vizinhos" << std::endl;
+            return false;
+        }
+
+        int previousSegment = (segment + numSegments - 1) % numSegments;
+        previousLink = std::make_unique<PeerLink>(std::format("enlace {}<-{}", segment, previousSegment),
+                                                  previousFd,
+                                                  [this](const PartitionMessage& m) { onPreviousMessage(m); },
+                                                  [this] { localChopsticks[0]->abortRemote(); });
+        nextLink = std::make_unique<PeerLink>(std::format("enlace {}->{}", segment, (segment + 1) % numSegments),
+                                              nextFd,
+                                              [this](const PartitionMessage& m) { onNextMessage(m); },
+                                              [this] {
+                                                  // Nenhuma concessão virá mais: libera quem a espera
+                                                  running = false;
+                                                  remoteGranted.store(true);
+                                                  remoteGranted.notify_all();
+                                              });
+
+        // Só começa a ler depois que os dois enlaces existem: os callbacks usam ambos
+        previousLink->start();
+        nextLink->start();
+        return true;
+    }
+
+    /**
+     * @brief Mensagens do segmento anterior: pedidos e devoluções do nosso primeiro palito
+     */
+    void onPreviousMessage(const PartitionMessage& message) {
+        if (message.type == PartitionMessage::REQUEST) {
+            if (localChopsticks[0]->requestRemote(message.seq)) {
+                previousLink->post({PartitionMessage::GRANT, message.chopstick, message.seq});
+            }
+        } else if (message.type == PartitionMessage::RELEASE) {
+            localChopsticks[0]->releaseRemote();
+        }
+    }
+
+    /**
+     * @brief Mensagens do segmento seguinte: concessões do palito remoto
+     */
+    void onNextMessage(const PartitionMessage& message) {
+        if (message.type == PartitionMessage::GRANT && message.seq == requestSeq.load()) {
+            auto sentAt = std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(requestedAt.load(std::memory_order_relaxed)));
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - sentAt).count();
+            nextLink->roundTrip().record(static_cast<uint64_t>(elapsed));
+            remoteGranted.store(true);
+            remoteGranted.notify_all();
+        }
+    }
+
+    /**
+     * @brief Pega um palito pelo ID global, local ou remoto
+     * @return false se a mesa foi encerrada durante a espera (o palito não foi pego)
+     */
+    bool acquireChopstick(int chopstick) {
+        if (isLocal(chopstick)) {
+            return localChopsticks[chopstick - first]->acquire(running);
+        }
+
+        // Palito do segmento seguinte: pede e espera a concessão (ou o encerramento)
+        remoteGranted.store(false);
+        requestedAt.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        nextLink->post({PartitionMessage::REQUEST, static_cast<uint32_t>(chopstick), ++requestSeq});
+        while (!remoteGranted.load() && running) {
+            remoteGranted.wait(false);
+        }
+        // Numa concessão que chega junto com o encerramento, o palito não é devolvido;
+        // o vizinho o recupera quando o enlace fecha (abortRemote)
+        return running;
+    }
+
+    /**
+     * @brief Solta um palito pelo ID global, local ou remoto
+     */
+    void releaseChopstick(int chopstick) {
+        if (isLocal(chopstick)) {
+            localChopsticks[chopstick - first]->release([this, chopstick](uint32_t seq) {
+                previousLink->post({PartitionMessage::GRANT, static_cast<uint32_t>(chopstick), seq});
+            });
+            return;
+        }
+        nextLink->post({PartitionMessage::RELEASE, static_cast<uint32_t>(chopstick), requestSeq});
+    }
+
+    bool isLocal(int chopstick) const {
+        return chopstick >= first && chopstick < first + static_cast<int>(philosophers.size());
+    }
+
+    void printReport(std::chrono::steady_clock::duration elapsed) {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << std::format("Segmento {}: refeições={} ({:.1f}/s)\n", segment, getMeals(),
+                                 seconds > 0 ? getMeals() / seconds : 0.0);
+        if (previousLink) {
+            std::cout << "  " << previousLink->report() << "\n";
+        }
+        if (nextLink) {
+            std::cout << "  " << nextLink->report() << "\n";
+        }
+        std::cout.flush();
+    }
+
+    /**
+     * @brief Ciclo de vida de um filósofo do segmento
+     * @param index Índice local do filósofo (0 a n-1)
+     */
+    void philosopherLifecycle(int index) {
+        int philosopherId = first + index;
+        int leftChopstick = philosopherId;
+        int rightChopstick = (philosopherId + 1) % totalPhilosophers;
+
+        while (running) {
+            // Pensar
+            philosophers[index]->think();
+
+            // Pegar os palitos: o de menor número primeiro
+            int lower = std::min(leftChopstick, rightChopstick);
+            int higher = std::max(leftChopstick, rightChopstick);
+            if (!acquireChopstick(lower)) {
+                break;
+            }
+            if (!acquireChopstick(higher)) {
+                // Encerrado enquanto esperava o segundo palito: devolve o primeiro e sai
+                releaseChopstick(lower);
+                break;
+            }
+            philosophers[index]->pickUpLeftChopstick();
+            philosophers[index]->pickUpRightChopstick();
+
+            // Comer
+            philosophers[index]->eat();
+            meals.fetch_add(1, std::memory_order_relaxed);
+
+            // Soltar os palitos
+            philosophers[index]->putDownRightChopstick();
+            releaseChopstick(rightChopstick);
+            philosophers[index]->putDownLeftChopstick();
+            releaseChopstick(leftChopstick);
+        }
+    }
+};
@@ -1,9 +1,11 @@
 #include "../include/dining_table.h"
+#include "../include/lock_profiler.h"
 #include <iostream>
 #include <pthread.h>
 #include <unistd.h>
 #include <vector>
 #include <atomic>
+#include <cstdint>
 
 /**
  * @brief Implementação da mesa de jantar usando monitores POSIX
@@ -16,9 +18,6 @@ public:
      */
     PosixDiningTable(int numPhilosophers, int socketnum)
         : DiningTable(numPhilosophers, socketnum) {
-        // Inicializa o mutex e as variáveis de condição
-        pthread_mutex_init(&mutex, NULL);
-        
         // Inicializa as variáveis de condição para cada filósofo
         cond.resize(numPhilosophers);
         for (int i = 0; i < numPhilosophers; i++) {
@@ -30,7 +29,6 @@ public:
      * @brief Destrutor para liberar recursos
      */
     ~PosixDiningTable() {
-        pthread_mutex_destroy(&mutex);
         for (size_t i = 0; i < cond.size(); i++) {
             pthread_cond_destroy(&cond[i]);
         }
@@ -43,7 +41,7 @@ public:
         std::string msg = std::format("Iniciando simulação com {} filósofos.\n", philosophers.size());
         msg = msg + "Implementação usando monitores POSIX.\n\n";
         msg = msg + "Esta implementação permite starvation.\n";
-        send(socketID, msg.c_str(), msg.size(), 0);
+        events.send(msg);
 
         // Armazena threads em um vetor
         std::vector<pthread_t> threads(philosophers.size());
@@ -61,19 +59,19 @@ public:
         }
         
         msg = "Simulação finalizada.\n";
-        send(socketID, msg.c_str(), msg.size(), 0);
+        events.send(msg);
     }
 
     /**
-     * @brief Para a execução da simulação
+     * @brief Retorna o número de refeições concluídas
      */
-    void stop() {
-        running = false;
+    uint64_t getMeals() const {
+        return meals.load(std::memory_order_relaxed);
     }
 
 private:
-    std::atomic<bool> running{true};  ///< Flag atômica para controlar a execução das threads
-    pthread_mutex_t mutex;            ///< Mutex POSIX para controlar acesso aos recursos
+    std::atomic<uint64_t> meals{0};   ///< Refeições concluídas
+    ProfiledPthreadMutex mutex{"PosixDiningTable::mutex"}; ///< Mutex POSIX para controlar acesso aos recursos
     std::vector<pthread_cond_t> cond; ///< Variáveis de condição para cada filósofo
     
     /**
@@ -129,26 +127,23 @@ private:
      * @param philosopher_number O número do filósofo (0 a n-1)
      */
     void pickup_forks(int philosopher_number) {
-        pthread_mutex_lock(&mutex);
+        mutex.lock(LockSite::PICKUP_FORKS);
         
         // Tenta pegar os palitos
         test(philosopher_number);
         
         // Se não conseguiu comer, espera até que possa
-        std::string msg;
-
         while (philosophers[philosopher_number]->getState() == State::HUNGRY) {
-            msg = std::format("Filósofo {} está esperando para comer\n", philosopher_number);
-            send(socketID, msg.c_str(), msg.size(), 0);
+            events.emit("Filósofo ", philosopher_number, " está esperando para comer\n");
 
-            pthread_cond_wait(&cond[philosopher_number], &mutex);
+            mutex.wait(&cond[philosopher_number]);
         }
         
         // Pega os palitos
         philosophers[philosopher_number]->pickUpLeftChopstick();
         philosophers[philosopher_number]->pickUpRightChopstick();
         
-        pthread_mutex_unlock(&mutex);
+        mutex.unlock();
     }
     
     /**
@@ -157,10 +152,11 @@ private:
      * @param philosopher_number O número do filósofo (0 a n-1)
      */
     void return_forks(int philosopher_number) {
-        pthread_mutex_lock(&mutex);
+        mutex.lock(LockSite::RETURN_FORKS);
         
         // Filósofo volta a pensar
         philosophers[philosopher_number]->setState(State::THINKING);
+        meals.fetch_add(1, std::memory_order_relaxed);
         
         // Solta os palitos
         philosophers[philosopher_number]->putDownLeftChopstick();
@@ -173,7 +169,7 @@ private:
         test(left);
         test(right);
         
-        pthread_mutex_unlock(&mutex);
+        mutex.unlock();
     }
     
     /**
@@ -1,4 +1,7 @@
 #include "../include/dining_table.h"
+#include "../include/latency_histogram.h"
+#include "../include/concurrency_gauge.h"
+#include "../include/lock_profiler.h"
 #include <iostream>
 #include <pthread.h>
 #include <unistd.h>
@@ -19,9 +22,6 @@ public:
      */
     PosixAgingDiningTable(int numPhilosophers, int socketnum)
         : DiningTable(numPhilosophers, socketnum) {
-        // Inicializa o mutex e as variáveis de condição
-        pthread_mutex_init(&mutex, NULL);
-        
         // Inicializa as variáveis de condição para cada filósofo
         cond.resize(numPhilosophers);
         for (int i = 0; i < numPhilosophers; i++) {
@@ -39,13 +39,15 @@ public:
         
         // Define o limiar de starvation (em milissegundos)
         starvationThreshold = 10000; // 10 segundos
+        
+        // Reserva espaço para os candidatos, evitando alocação no caminho crítico
+        candidates.reserve(numPhilosophers);
     }
     
     /**
      * @brief Destrutor para liberar recursos
      */
     ~PosixAgingDiningTable() {
-        pthread_mutex_destroy(&mutex);
         for (size_t i = 0; i < cond.size(); i++) {
             pthread_cond_destroy(&cond[i]);
         }
@@ -58,7 +60,7 @@ public:
         std::string msg = std::format("Iniciando simulação com {} filósofos.\n", philosophers.size());
         msg = msg + "Implementação usando monitores POSIX com mecanismo de aging.\n";
         msg = msg + "Esta implementação previne starvation.\n";
-        send(socketID, msg.c_str(), msg.size(), 0);
+        events.send(msg);
 
         // Armazena threads em um vetor
         std::vector<pthread_t> threads(philosophers.size());
@@ -75,24 +77,48 @@ public:
             pthread_join(thread, NULL);
         }
         
-        msg = "Simulação finalizada.\n";
-        send(socketID, msg.c_str(), msg.size(), 0);
+        msg = std::format("Média de filósofos comendo simultaneamente: {:.2f} (limite N/2 = {})\n",
+                          getAverageEaters(), philosophers.size() / 2);
+        msg = msg + "Simulação finalizada.\n";
+        events.send(msg);
+    }
+
+    /**
+     * @brief Retorna o histograma de espera entre ficar com fome e começar a comer (µs)
+     */
+    const LatencyHistogram& getWaitHistogram() const {
+        return waitHistogram;
     }
 
     /**
-     * @brief Para a execução da simulação
+     * @brief Retorna a média temporal de filósofos comendo simultaneamente
      */
-    void stop() {
-        running = false;
+    double getAverageEaters() {
+        mutex.lock(LockSite::STATS);
+        double average = eaters.average();
+        mutex.unlock();
+        return average;
+    }
+
+    /**
+     * @brief Acrescenta a espera e a concorrência ao resumo da mesa
+     */
+    std::string stats() override {
+        return DiningTable::stats() +
+               std::format(" espera(µs) p50={} p99={} max={} comendo={:.2f}/{}",
+                           waitHistogram.percentile(50), waitHistogram.percentile(99), waitHistogram.max(),
+                           getAverageEaters(), philosophers.size() / 2);
     }
 
 private:
-    std::atomic<bool> running{true};      ///< Flag atômica para controlar a execução das threads
-    pthread_mutex_t mutex;                ///< Mutex POSIX para controlar acesso aos recursos
+    ProfiledPthreadMutex mutex{"PosixAgingDiningTable::mutex"}; ///< Mutex POSIX para controlar acesso aos recursos
     std::vector<pthread_cond_t> cond;     ///< Variáveis de condição para cada filósofo
     std::vector<int> waitingTime;         ///< Contador de espera para cada filósofo
     std::vector<std::chrono::steady_clock::time_point> lastEatTime;  ///< Timestamp da última vez que cada filósofo comeu
     int starvationThreshold;              ///< Limiar de tempo para considerar starvation (ms)
+    LatencyHistogram waitHistogram;       ///< Tempo de espera até comer (µs)
+    ConcurrencyGauge eaters;              ///< Filósofos comendo simultaneamente
+    std::vector<std::pair<int, int>> candidates; ///< Famintos elegíveis (prioridade, ID)
     
     /**
      * @brief Estrutura para passar dados para as threads
@@ -128,46 +154,62 @@ private:
     }
     
     /**
-     * @brief Encontra o filósofo faminto com maior tempo de espera entre os que podem comer
-     * @return ID do filósofo selecionado ou -1 se nenhum for elegível
+     * @brief Calcula a prioridade de aging de um filósofo faminto
+     * @param philosopher_number ID do filósofo
+     * @param now Instante atual
+     * @return Prioridade (maior = deve comer antes)
      */
-    int selectHungryPhilosopher() {
-        int selectedPhilosopher = -1;
-        int maxWaitingTime = -1;
+    int agingPriority(int philosopher_number, std::chrono::steady_clock::time_point now) {
+        // Calcula o tempo de espera desde a última refeição
+        auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - lastEatTime[philosopher_number]).count();
+        
+        // Calcula prioridade baseada no tempo de espera e no contador de aging
+        return waitingTime[philosopher_number] + (waitTime > starvationThreshold ? 1000 : 0);
+    }
+    
+    /**
+     * @brief Preenche candidates com os filósofos famintos que podem comer,
+     * ordenados do maior para o menor tempo de espera
+     */
+    void collectHungryPhilosophers() {
         auto now = std::chrono::steady_clock::now();
+        candidates.clear();
         
         for (size_t i = 0; i < philosophers.size(); i++) {
             if (philosophers[i]->getState() == State::HUNGRY && canEat(i)) {
-                // Calcula o tempo de espera desde a última refeição
-                auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    now - lastEatTime[i]).count();
-                
-                // Calcula prioridade baseada no tempo de espera e no contador de aging
-                int priority = waitingTime[i] + (waitTime > starvationThreshold ? 1000 : 0);
-                
-                // Seleciona o filósofo com maior prioridade
-                if (priority > maxWaitingTime) {
-                    maxWaitingTime = priority;
-                    selectedPhilosopher = i;
-                }
+                candidates.push_back({agingPriority(i, now), static_cast<int>(i)});
             }
         }
         
-        return selectedPhilosopher;
+        // Maior prioridade primeiro; empates resolvidos pelo menor ID
+        std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
     }
     
     /**
-     * @brief Tenta encontrar o próximo filósofo que deve comer, com base no mecanismo de aging
+     * @brief Libera de uma vez um conjunto maximal de filósofos famintos sem conflito
+     *
+     * Percorre os elegíveis por ordem de aging e concede os palitos a cada um cujos
+     * vizinhos ainda não estejam comendo (incluindo os liberados nesta passada).
+     * Ao final, todo filósofo faminto não liberado tem um vizinho comendo.
      */
     void testWithAging() {
-        int selectedPhilosopher = selectHungryPhilosopher();
+        ProfiledPthreadMutex::SiteScope scope(mutex, LockSite::TEST_WITH_AGING);
+        collectHungryPhilosophers();
         
-        if (selectedPhilosopher >= 0) {
+        for (const auto& [priority, selectedPhilosopher] : candidates) {
+            if (!canEat(selectedPhilosopher)) {
+                continue; // Um vizinho foi liberado nesta passada
+            }
+            
             // Reseta o contador de espera para este filósofo
             waitingTime[selectedPhilosopher] = 0;
             
             // Atualiza o estado do filósofo para EATING
             philosophers[selectedPhilosopher]->setState(State::EATING);
+            eaters.increment();
             
             // Sinaliza que o filósofo pode comer
             pthread_cond_signal(&cond[selectedPhilosopher]);
@@ -180,28 +222,28 @@ private:
      * @param philosopher_number O número do filósofo (0 a n-1)
      */
     void pickup_forks(int philosopher_number) {
-        pthread_mutex_lock(&mutex);
+        auto hungrySince = std::chrono::steady_clock::now();
+        mutex.lock(LockSite::PICKUP_FORKS);
         
-        // Define o estado como faminto
-        philosophers[philosopher_number]->setState(State::HUNGRY);
+        // Define o estado como faminto, sem descartar uma liberação concedida
+        // enquanto o filósofo ainda não tinha entrado no monitor
+        if (philosophers[philosopher_number]->getState() != State::EATING) {
+            philosophers[philosopher_number]->setState(State::HUNGRY);
+        }
         
         // Tenta encontrar um filósofo para comer com base no aging
         testWithAging();
         
         // Se não conseguiu comer, espera até que possa
-        std::string msg;
-
         while (philosophers[philosopher_number]->getState() == State::HUNGRY) {
             // Incrementa o contador de espera a cada tentativa frustrada
             waitingTime[philosopher_number]++;
 
-            msg = std::format("Filósofo {} aguardando (tempo de espera: {})\n", 
-                        philosopher_number,
-                        waitingTime[philosopher_number]);
-            send(socketID, msg.c_str(), msg.size(), 0);
+            events.emit("Filósofo ", philosopher_number, " aguardando (tempo de espera: ",
+                        waitingTime[philosopher_number], ")\n");
 
             // Espera ser sinalizado
-            pthread_cond_wait(&cond[philosopher_number], &mutex);
+            mutex.wait(&cond[philosopher_number]);
         }
         
         // Pega os palitos
@@ -210,8 +252,13 @@ private:
         
         // Atualiza o timestamp da última refeição
         lastEatTime[philosopher_number] = std::chrono::steady_clock::now();
+
+        // Registra quanto tempo o filósofo esperou
+        auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+            lastEatTime[philosopher_number] - hungrySince).count();
+        waitHistogram.record(static_cast<uint64_t>(waited));
         
-        pthread_mutex_unlock(&mutex);
+        mutex.unlock();
     }
     
     /**
@@ -220,7 +267,12 @@ private:
      * @param philosopher_number O número do filósofo (0 a n-1)
      */
     void return_forks(int philosopher_number) {
-        pthread_mutex_lock(&mutex);
+        mutex.lock(LockSite::RETURN_FORKS);
+        eaters.decrement();
+
+        // Filósofo volta a pensar
+        philosophers[philosopher_number]->setState(State::THINKING);
+        
         // Solta os palitos
         philosophers[philosopher_number]->putDownLeftChopstick();
         philosophers[philosopher_number]->putDownRightChopstick();
@@ -228,7 +280,7 @@ private:
         // Tenta encontrar o próximo filósofo para comer com base no aging
         testWithAging();
         
-        pthread_mutex_unlock(&mutex);
+        mutex.unlock();
     }
     
     /**
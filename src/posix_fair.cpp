@@ -0,0 +1,265 @@
+#include "../include/dining_table.h"
+#include "../include/latency_histogram.h"
+#include "../include/concurrency_gauge.h"
+#include <iostream>
+#include <pthread.h>
+#include <unistd.h>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Implementação da mesa de jantar usando monitores POSIX com ordem FIFO (espera limitada)
+ *
+ * Cada filósofo recebe uma senha (ticket) crescente ao ficar com fome. Um filósofo
+ * faminto só come se nenhum vizinho estiver comendo e nenhum vizinho faminto tiver
+ * uma senha mais antiga. Assim, enquanto um filósofo espera, cada vizinho come no
+ * máximo uma vez antes dele, e a cadeia de dependências segue senhas estritamente
+ * decrescentes: a espera fica limitada a (N - 1) refeições, sem depender de limiar.
+ */
+class PosixFairDiningTable : public DiningTable {
+public:
+    /**
+     * @brief Construtor para a mesa com monitores POSIX e ordem FIFO
+     * @param numPhilosophers O número de filósofos na mesa (padrão: 5)
+     */
+    PosixFairDiningTable(int numPhilosophers, int socketnum)
+        : DiningTable(numPhilosophers, socketnum) {
+        // Inicializa o mutex e as variáveis de condição
+        pthread_mutex_init(&mutex, NULL);
+
+        // Inicializa as variáveis de condição para cada filósofo
+        cond.resize(numPhilosophers);
+        for (int i = 0; i < numPhilosophers; i++) {
+            pthread_cond_init(&cond[i], NULL);
+        }
+
+        // Inicializa as senhas e os instantes em que cada filósofo ficou com fome
+        ticket.resize(numPhilosophers, 0);
+        queued.resize(numPhilosophers, false);
+        hungrySince.resize(numPhilosophers, std::chrono::steady_clock::now());
+    }
+
+    /**
+     * @brief Destrutor para liberar recursos
+     */
+    ~PosixFairDiningTable() {
+        pthread_mutex_destroy(&mutex);
+        for (size_t i = 0; i < cond.size(); i++) {
+            pthread_cond_destroy(&cond[i]);
+        }
+    }
+
+    /**
+     * @brief Executa a simulação dos filósofos
+     */
+    void run() override {
+        std::string msg = std::format("Iniciando simulação com {} filósofos.\n", philosophers.size());
+        msg = msg + "Implementação usando monitores POSIX com ordem FIFO por vizinhança.\n";
+        msg = msg + "Esta implementação garante espera limitada.\n";
+        events.send(msg);
+
+        // Armazena threads em um vetor
+        std::vector<pthread_t> threads(philosophers.size());
+
+        // Cria uma thread para cada filósofo
+        for (size_t i = 0; i < philosophers.size(); i++) {
+            pthread_create(&threads[i], NULL,
+                           &PosixFairDiningTable::philosopherLifecycleStatic,
+                           new ThreadData{this, static_cast<int>(i)});
+        }
+
+        // Aguarda todas as threads terminarem
+        for (auto& thread : threads) {
+            pthread_join(thread, NULL);
+        }
+
+        msg = std::format("Média de filósofos comendo simultaneamente: {:.2f} (limite N/2 = {})\n",
+                          getAverageEaters(), philosophers.size() / 2);
+        msg = msg + "Simulação finalizada.\n";
+        events.send(msg);
+    }
+
+    /**
+     * @brief Retorna o histograma de espera entre ficar com fome e começar a comer (µs)
+     */
+    const LatencyHistogram& getWaitHistogram() const {
+        return waitHistogram;
+    }
+
+    /**
+     * @brief Retorna a média temporal de filósofos comendo simultaneamente
+     */
+    double getAverageEaters() {
+        pthread_mutex_lock(&mutex);
+        double average = eaters.average();
+        pthread_mutex_unlock(&mutex);
+        return average;
+    }
+
+    /**
+     * @brief Acrescenta a espera e a concorrência ao resumo da mesa
+     */
+    std::string stats() override {
+        return DiningTable::stats() +
+               std::format(" espera(µs) p50={} p99={} max={} comendo={:.2f}/{}",
+                           waitHistogram.percentile(50), waitHistogram.percentile(99), waitHistogram.max(),
+                           getAverageEaters(), philosophers.size() / 2);
+    }
+
+private:
+    pthread_mutex_t mutex;                ///< Mutex POSIX para controlar acesso aos recursos
+    std::vector<pthread_cond_t> cond;     ///< Variáveis de condição para cada filósofo
+    std::vector<uint64_t> ticket;         ///< Senha de cada filósofo faminto (menor = mais antigo)
+    std::vector<bool> queued;             ///< Indica se o filósofo está na fila do monitor
+    uint64_t nextTicket = 0;              ///< Próxima senha a ser distribuída
+    std::vector<std::chrono::steady_clock::time_point> hungrySince; ///< Instante em que cada filósofo ficou com fome
+    LatencyHistogram waitHistogram;       ///< Tempo de espera até comer (µs)
+    ConcurrencyGauge eaters;              ///< Filósofos comendo simultaneamente
+
+    /**
+     * @brief Estrutura para passar dados para as threads
+     */
+    struct ThreadData {
+        PosixFairDiningTable* table;
+        int id;
+    };
+
+    /**
+     * @brief Função estática para iniciar o ciclo de vida do filósofo
+     * @param arg Dados da thread (ponteiro para ThreadData)
+     * @return void* Retorno não usado
+     */
+    static void* philosopherLifecycleStatic(void* arg) {
+        ThreadData* data = static_cast<ThreadData*>(arg);
+        data->table->philosopherLifecycle(data->id);
+        delete data;
+        return NULL;
+    }
+
+    /**
+     * @brief Verifica se um vizinho faminto tem prioridade sobre o filósofo
+     * @param philosopher_number ID do filósofo
+     * @param neighbor ID do vizinho
+     * @return true se o vizinho está na fila há mais tempo
+     */
+    bool yieldsTo(int philosopher_number, int neighbor) {
+        return queued[neighbor] && ticket[neighbor] < ticket[philosopher_number];
+    }
+
+    /**
+     * @brief Verifica se o filósofo pode comer
+     * @param philosopher_number ID do filósofo
+     * @return true se nenhum vizinho come nem tem senha mais antiga
+     */
+    bool canEat(int philosopher_number) {
+        int left = (philosopher_number + philosophers.size() - 1) % philosophers.size();
+        int right = (philosopher_number + 1) % philosophers.size();
+
+        return philosophers[left]->getState() != State::EATING &&
+               philosophers[right]->getState() != State::EATING &&
+               !yieldsTo(philosopher_number, left) &&
+               !yieldsTo(philosopher_number, right);
+    }
+
+    /**
+     * @brief Tenta fazer o filósofo comer se possível
+     * @param philosopher_number ID do filósofo
+     */
+    void test(int philosopher_number) {
+        if (queued[philosopher_number] && canEat(philosopher_number)) {
+            // Filósofo pode comer: sai da fila
+            queued[philosopher_number] = false;
+            philosophers[philosopher_number]->setState(State::EATING);
+            eaters.increment();
+
+            // Sinaliza que o filósofo pode comer
+            pthread_cond_signal(&cond[philosopher_number]);
+        }
+    }
+
+    /**
+     * @brief Implementação da interface do jantar dos filósofos utilizando POSIX com ordem FIFO
+     * Função pickup_forks - cada filósofo chama quando quer comer
+     * @param philosopher_number O número do filósofo (0 a n-1)
+     */
+    void pickup_forks(int philosopher_number) {
+        auto now = std::chrono::steady_clock::now();
+        pthread_mutex_lock(&mutex);
+
+        // Entra na fila: recebe a próxima senha
+        philosophers[philosopher_number]->setState(State::HUNGRY);
+        ticket[philosopher_number] = nextTicket++;
+        queued[philosopher_number] = true;
+        hungrySince[philosopher_number] = now;
+
+        // Tenta pegar os palitos
+        test(philosopher_number);
+
+        // Se não conseguiu comer, espera até que possa
+        while (queued[philosopher_number]) {
+            events.emit("Filósofo ", philosopher_number, " está esperando na fila (senha ",
+                        ticket[philosopher_number], ")\n");
+
+            pthread_cond_wait(&cond[philosopher_number], &mutex);
+        }
+
+        // Registra quanto tempo o filósofo esperou
+        auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - hungrySince[philosopher_number]).count();
+        waitHistogram.record(static_cast<uint64_t>(waited));
+
+        // Pega os palitos
+        philosophers[philosopher_number]->pickUpLeftChopstick();
+        philosophers[philosopher_number]->pickUpRightChopstick();
+
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * @brief Implementação da interface do jantar dos filósofos utilizando POSIX com ordem FIFO
+     * Função return_forks - cada filósofo chama quando termina de comer
+     * @param philosopher_number O número do filósofo (0 a n-1)
+     */
+    void return_forks(int philosopher_number) {
+        pthread_mutex_lock(&mutex);
+
+        // Filósofo volta a pensar
+        philosophers[philosopher_number]->setState(State::THINKING);
+        eaters.decrement();
+
+        // Solta os palitos
+        philosophers[philosopher_number]->putDownLeftChopstick();
+        philosophers[philosopher_number]->putDownRightChopstick();
+
+        // Verifica se os filósofos vizinhos podem comer
+        int left = (philosopher_number + philosophers.size() - 1) % philosophers.size();
+        int right = (philosopher_number + 1) % philosophers.size();
+
+        test(left);
+        test(right);
+
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * @brief Ciclo de vida de um filósofo
+     * @param philosopherId ID do filósofo
+     */
+    void philosopherLifecycle(int philosopherId) {
+        while (running) {
+            // Pensar
+            philosophers[philosopherId]->think();
+
+            // Pegar os palitos
+            pickup_forks(philosopherId);
+
+            // Comer
+            philosophers[philosopherId]->eat();
+
+            // Soltar os palitos
+            return_forks(philosopherId);
+        }
+    }
+};
@@ -5,18 +5,38 @@
 #include <semaphore>
 #include <functional>
 #include <atomic>
+#include <algorithm>
+#include <random>
+#include <chrono>
 
 /**
- * @brief Implementação da mesa de jantar usando semáforos, permitindo deadlocks
+ * @brief Estratégias de aquisição dos palitos na mesa com semáforos
+ */
+enum class SemaphoreStrategy {
+    NAIVE,              ///< Esquerdo e depois direito (permite deadlock)
+    RESOURCE_HIERARCHY, ///< Palito de menor número primeiro
+    BUTLER,             ///< Garçom admite no máximo N-1 filósofos à mesa
+    TRY_BACKOFF         ///< Tenta o segundo palito; se falhar, solta o primeiro e recua
+};
+
+/**
+ * @brief Implementação da mesa de jantar usando semáforos
+ *
+ * A estratégia ingênua permite deadlocks; as demais são livres de deadlock e
+ * contam refeições e tentativas frustradas para comparação de custo.
  */
 class SemaphoreDiningTable : public DiningTable {
 public:
     /**
      * @brief Construtor para a mesa com semáforos
      * @param numPhilosophers O número de filósofos na mesa (padrão: 5)
+     * @param strategy Estratégia de aquisição dos palitos (padrão: ingênua)
      */
-    SemaphoreDiningTable(int numPhilosophers, int socketnum)
-        : DiningTable(numPhilosophers, socketnum) {
+    SemaphoreDiningTable(int numPhilosophers, int socketnum,
+                         SemaphoreStrategy strategy = SemaphoreStrategy::NAIVE)
+        : DiningTable(numPhilosophers, socketnum),
+          strategy(strategy),
+          butler(std::max(numPhilosophers - 1, 1)) {
         // Inicializa os semáforos para os palitos (todos disponíveis inicialmente)
         chopstickSemaphores.clear(); // Garante que o vetor esteja vazio
         for (int i = 0; i < numPhilosophers; i++) {
@@ -29,75 +49,237 @@ public:
      */
     void run() override {
         std::string msg = std::format("Iniciando simulação com {} filósofos.\n", philosophers.size());
-        msg = msg + "Esta implementação permite deadlocks.\n\n";
+        msg = msg + strategyDescription() + "\n\n";
+
+        events.send(msg);
+
+        auto start = std::chrono::steady_clock::now();
 
-        send(socketID, msg.c_str(), msg.size(), 0);
-        
         // Cria uma thread para cada filósofo
         std::vector<std::thread> threads;
         for (size_t i = 0; i < philosophers.size(); i++) {
             threads.emplace_back(&SemaphoreDiningTable::philosopherLifecycle, this, i);
         }
-        
+
         // Aguarda todas as threads terminarem
         for (auto& thread : threads) {
             if (thread.joinable()) {
                 thread.join();
             }
         }
-        
-        msg = "Simulação finalizada.\n";
-        send(socketID, msg.c_str(), msg.size(), 0);
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        msg = std::format("Refeições: {} ({:.2f}/s), tentativas frustradas: {}\n",
+                          getMeals(), elapsed > 0 ? getMeals() / elapsed : 0.0, getRetries());
+        msg = msg + "Simulação finalizada.\n";
+        events.send(msg);
+    }
+
+    /**
+     * @brief Retorna o número de refeições concluídas
+     */
+    uint64_t getMeals() const {
+        return meals.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Retorna o número de vezes que um filósofo soltou o primeiro palito e recuou
+     */
+    uint64_t getRetries() const {
+        return retries.load(std::memory_order_relaxed);
     }
 
     /**
-     * @brief Para a execução da simulação
+     * @brief Acrescenta as tentativas frustradas ao resumo da mesa
      */
-    void stop() {
-        running = false;
+    std::string stats() override {
+        return DiningTable::stats() + std::format(" tentativas={}", getRetries());
     }
 
 private:
-    std::atomic<bool> running{true};                      ///< Flag atômica para controlar a execução das threads
     std::vector<std::unique_ptr<std::binary_semaphore>> chopstickSemaphores; ///< Semáforos para os palitos
+    SemaphoreStrategy strategy;                           ///< Estratégia de aquisição dos palitos
+    std::counting_semaphore<> butler;                     ///< Garçom: admite no máximo N-1 filósofos
+    std::atomic<uint64_t> meals{0};                       ///< Refeições concluídas
+    std::atomic<uint64_t> retries{0};                     ///< Recuos da estratégia com tentativa
+
+    static constexpr int BACKOFF_MIN_US = 50;     ///< Recuo inicial (µs)
+    static constexpr int BACKOFF_MAX_US = 10000;  ///< Teto do recuo exponencial (µs)
+    static constexpr std::chrono::milliseconds STOP_POLL{100}; ///< Intervalo para checar a parada durante esperas
+
+    /**
+     * @brief Retorna a descrição da estratégia exibida ao iniciar a simulação
+     */
+    std::string strategyDescription() const {
+        switch (strategy) {
+            case SemaphoreStrategy::RESOURCE_HIERARCHY:
+                return "Hierarquia de recursos: o palito de menor número é pego primeiro.\n"
+                       "Esta implementação evita deadlocks.";
+            case SemaphoreStrategy::BUTLER:
+                return std::format("Garçom: no máximo {} filósofos disputam os palitos ao mesmo tempo.\n"
+                                   "Esta implementação evita deadlocks.", philosophers.size() - 1);
+            case SemaphoreStrategy::TRY_BACKOFF:
+                return "Tentativa com recuo exponencial aleatório.\n"
+                       "Esta implementação evita deadlocks.";
+            default:
+                return "Esta implementação permite deadlocks.";
+        }
+    }
+
+    /**
+     * @brief Espera o semáforo, desistindo se a simulação for parada
+     * @return true se o semáforo foi adquirido
+     */
+    template <typename Semaphore>
+    bool acquireWhileRunning(Semaphore& semaphore) {
+        while (!semaphore.try_acquire_for(STOP_POLL)) {
+            if (!running) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Pega um palito e registra no filósofo qual lado foi pego
+     * @param philosopherId ID do filósofo
+     * @param chopstick Índice do palito
+     * @return false se a simulação foi parada durante a espera
+     */
+    bool takeChopstick(int philosopherId, int chopstick) {
+        bool left = chopstick == philosopherId;
+        events.emit("Filósofo ", philosopherId, " tentando pegar o palito ", left ? "esquerdo\n" : "direito\n");
+
+        if (!acquireWhileRunning(*chopstickSemaphores[chopstick])) {
+            return false;
+        }
+        if (left) {
+            philosophers[philosopherId]->pickUpLeftChopstick();
+        } else {
+            philosophers[philosopherId]->pickUpRightChopstick();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Solta um palito e registra no filósofo qual lado foi solto
+     * @param philosopherId ID do filósofo
+     * @param chopstick Índice do palito
+     */
+    void dropChopstick(int philosopherId, int chopstick) {
+        if (chopstick == philosopherId) {
+            philosophers[philosopherId]->putDownLeftChopstick();
+        } else {
+            philosophers[philosopherId]->putDownRightChopstick();
+        }
+        chopstickSemaphores[chopstick]->release();
+    }
+
+    /**
+     * @brief Pega dois palitos na ordem dada
+     * @return false se a simulação foi parada (nenhum palito fica preso)
+     */
+    bool takeInOrder(int philosopherId, int first, int second) {
+        if (!takeChopstick(philosopherId, first)) {
+            return false;
+        }
+        if (!takeChopstick(philosopherId, second)) {
+            dropChopstick(philosopherId, first);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Tenta pegar o palito direito sem bloquear, recuando em caso de falha
+     * @param philosopherId ID do filósofo
+     * @param gen Gerador aleatório da thread
+     * @return false se a simulação foi parada
+     */
+    bool takeWithBackoff(int philosopherId, std::mt19937& gen) {
+        int leftChopstick = philosopherId;
+        int rightChopstick = (philosopherId + 1) % philosophers.size();
+        int backoffUs = BACKOFF_MIN_US;
+
+        while (true) {
+            if (!takeChopstick(philosopherId, leftChopstick)) {
+                return false;
+            }
+
+            if (chopstickSemaphores[rightChopstick]->try_acquire()) {
+                philosophers[philosopherId]->pickUpRightChopstick();
+                return true;
+            }
+
+            // Não conseguiu o direito: solta o esquerdo e espera um tempo aleatório
+            dropChopstick(philosopherId, leftChopstick);
+            retries.fetch_add(1, std::memory_order_relaxed);
+
+            std::uniform_int_distribution<> distrib(0, backoffUs);
+            std::this_thread::sleep_for(std::chrono::microseconds(distrib(gen)));
+            backoffUs = std::min(backoffUs * 2, BACKOFF_MAX_US);
+        }
+    }
 
     /**
      * @brief Ciclo de vida de um filósofo
      * @param philosopherId ID do filósofo
      */
     void philosopherLifecycle(int philosopherId) {
-        std::string msg;
+        std::random_device rd;
+        std::mt19937 gen(rd());
+
+        // Palitos do filósofo: o esquerdo tem o mesmo número do filósofo
+        int leftChopstick = philosopherId;
+        int rightChopstick = (philosopherId + 1) % philosophers.size();
+
         while (running) {
             // Pensar
             philosophers[philosopherId]->think();
-            
-            // Tentar pegar os palitos (primeiro o esquerdo, depois o direito)
-            int leftChopstick = philosopherId;
-            int rightChopstick = (philosopherId + 1) % philosophers.size();
-            
-            // Tenta pegar o palito esquerdo
-            msg = std::format ("Filósofo {} tentando pegar o palito esquerdo\n", philosopherId);
-            send(socketID, msg.c_str(), msg.size(), 0);
-
-            chopstickSemaphores[leftChopstick]->acquire();
-            philosophers[philosopherId]->pickUpLeftChopstick();
-            
-            // Tenta pegar o palito direito
-            msg = std::format ("Filósofo {} tentando pegar o palito direito\n", philosopherId);
-            send(socketID, msg.c_str(), msg.size(), 0);
 
-            chopstickSemaphores[rightChopstick]->acquire();
-            philosophers[philosopherId]->pickUpRightChopstick();
-            
+            // Tentar pegar os palitos de acordo com a estratégia
+            bool acquired = false;
+            switch (strategy) {
+                case SemaphoreStrategy::RESOURCE_HIERARCHY:
+                    acquired = takeInOrder(philosopherId, std::min(leftChopstick, rightChopstick),
+                                           std::max(leftChopstick, rightChopstick));
+                    break;
+
+                case SemaphoreStrategy::BUTLER:
+                    if (acquireWhileRunning(butler)) {
+                        acquired = takeInOrder(philosopherId, leftChopstick, rightChopstick);
+                        if (!acquired) {
+                            butler.release();
+                        }
+                    }
+                    break;
+
+                case SemaphoreStrategy::TRY_BACKOFF:
+                    acquired = takeWithBackoff(philosopherId, gen);
+                    break;
+
+                default:
+                    // Primeiro o esquerdo, depois o direito
+                    acquired = takeInOrder(philosopherId, leftChopstick, rightChopstick);
+                    break;
+            }
+
+            // Parada durante a espera (inclusive em deadlock): sai sem segurar palitos
+            if (!acquired) {
+                break;
+            }
+
             // Comer
             philosophers[philosopherId]->eat();
-            
+            meals.fetch_add(1, std::memory_order_relaxed);
+
             // Soltar os palitos
-            philosophers[philosopherId]->putDownRightChopstick();
-            chopstickSemaphores[rightChopstick]->release();
-            
-            philosophers[philosopherId]->putDownLeftChopstick();
-            chopstickSemaphores[leftChopstick]->release();
+            dropChopstick(philosopherId, rightChopstick);
+            dropChopstick(philosopherId, leftChopstick);
+
+            if (strategy == SemaphoreStrategy::BUTLER) {
+                butler.release();
+            }
         }
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,517 @@
+#include "../include/dining_table.h"
+#include "../include/lock_profiler.h"
+#include "../include/resource_governor.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <charconv>
+#include "semaphore.cpp"
+#include "posix.cpp"
+#include "posix_aging.cpp"
+#include "posix_fair.cpp"
+#include "shared_memory.cpp"
+
+/**
+ * @brief Sessão de um cliente: protocolo de comandos por linha com várias mesas simultâneas
+ *
+ * Cada linha recebida é um comando. Vários comandos podem chegar em uma única
+ * escrita (pipeline); todos são tratados sem bloquear a leitura, pois cada mesa
+ * roda em sua própria thread. Os números do menu continuam aceitos como atalhos.
+ */
+class Session {
+public:
+    static constexpr size_t MAX_LINE = 1024;      ///< Maior linha aceita
+    static constexpr size_t MAX_TABLES = 8;       ///< Mesas simultâneas por sessão
+    static constexpr int MAX_PHILOSOPHERS = 1000; ///< Filósofos por mesa
+    static constexpr size_t STACK_BYTES = 64 << 10; ///< Pilha usada por thread de filósofo (estimativa)
+    /// Tipos de mesa aceitos por "start", na ordem das opções 1 a 8 do menu
+    static constexpr const char* TABLE_KINDS[] = {"semaphore", "posix", "aging", "fifo", "hierarchy", "butler",
+                                                  "backoff", "shm"};
+
+    /**
+     * @brief Construtor
+     * @param socket Socket do cliente
+     */
+    explicit Session(int socket) : socket(socket) {}
+
+    /**
+     * @brief Destrutor: para todas as mesas e aguarda suas threads
+     */
+    ~Session() {
+        for (auto& entry : tables) {
+            entry->stop();
+        }
+        for (auto& entry : tables) {
+            if (entry->thread.joinable()) {
+                entry->thread.join();
+            }
+        }
+    }
+
+    /**
+     * @brief Lê e executa comandos até "quit" ou até o cliente desconectar
+     */
+    void run() {
+        reply(banner());
+
+        std::string pending;
+        char buffer[4096];
+        while (true) {
+            ssize_t received = recv(socket, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return;
+            }
+            pending.append(buffer, received);
+
+            // Executa todas as linhas completas recebidas
+            size_t start = 0;
+            size_t end;
+            while ((end = pending.find('\n', start)) != std::string::npos) {
+                std::string line = pending.substr(start, end - start);
+                start = end + 1;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                if (!handleLine(line)) {
+                    return;
+                }
+            }
+            pending.erase(0, start);
+
+            if (pending.size() > MAX_LINE) {
+                reply("erro: linha muito longa\n");
+                pending.clear();
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Uma mesa da sessão
+     *
+     * A mesa só é construída pela thread dela depois de admitida pelo governador; até
+     * lá live é nulo e os comandos guardam o que pedem (parar, inscrição) para quando
+     * ela existir. O sequenciamento seq_cst entre live e stopRequested garante que um
+     * stop concorrente com a construção é visto por um dos dois lados.
+     */
+    struct RunningTable {
+        int id;
+        std::string kind;
+        int numPhilosophers;
+        int thinkMin, thinkMax, eat, workers;
+        std::unique_ptr<DiningTable> table;        ///< Escrito só pela thread da mesa
+        std::atomic<DiningTable*> live{nullptr};   ///< A mesa, depois de construída
+        std::thread thread;
+        std::atomic<bool> waiting{false};          ///< Na fila de admissão do servidor
+        std::atomic<bool> finished{false};
+        std::atomic<bool> stopRequested{false};
+        std::atomic<bool> subscribed{true};        ///< Inscrição pedida para os eventos
+        AdmissionTicket ticket;                    ///< Recursos reservados no governador
+
+        const char* status() const {
+            return finished ? "finalizada" : waiting ? "na fila" : "executando";
+        }
+
+        void stop() {
+            stopRequested = true;
+            ResourceGovernor::instance().cancel(ticket);
+            if (DiningTable* table = live.load()) {
+                table->stop();
+            }
+        }
+
+        void setSubscribed(bool value) {
+            subscribed = value;
+            if (DiningTable* table = live.load()) {
+                table->getEvents().setSubscribed(value);
+            }
+        }
+    };
+
+    int socket;                                         ///< Socket do cliente
+    int nextId = 1;                                     ///< ID da próxima mesa
+    std::vector<std::unique_ptr<RunningTable>> tables;  ///< Mesas da sessão
+    TableSnapshot snapshotView;                         ///< Destino de "snapshot", reaproveitado entre leituras
+
+    void reply(const std::string& msg) {
+        send(socket, msg.c_str(), msg.size(), MSG_NOSIGNAL);
+    }
+
+    static std::string banner() {
+        return
+        "\n"
+        "######   ##   ##  #######           #####     ####    ##   ##   ####    ##   ##    ####            ######   ##   ##   ####    ####      #####    #####    #####   ######   ##   ##  #######  ######    #####\n"
+        "# ## #   ##   ##   ##   #            ## ##     ##     ###  ##    ##     ###  ##   ##  ##            ##  ##  ##   ##    ##      ##      ##   ##  ##   ##  ##   ##   ##  ##  ##   ##   ##   #   ##  ##  ##   ##\n"
+        "  ##     ##   ##   ## #              ##  ##    ##     #### ##    ##     #### ##  ##                 ##  ##  ##   ##    ##      ##      ##   ##  #        ##   ##   ##  ##  ##   ##   ## #     ##  ##  #\n"
+        "  ##     #######   ####              ##  ##    ##     ## ####    ##     ## ####  ##                 #####   #######    ##      ##      ##   ##   #####   ##   ##   #####   #######   ####     #####    #####\n"
+        "  ##     ##   ##   ## #              ##  ##    ##     ##  ###    ##     ##  ###  ##  ###            ##      ##   ##    ##      ##   #  ##   ##       ##  ##   ##   ##      ##   ##   ## #     ## ##        ##\n"
+        "  ##     ##   ##   ##   #            ## ##     ##     ##   ##    ##     ##   ##   ##  ##            ##      ##   ##    ##      ##  ##  ##   ##  ##   ##  ##   ##   ##      ##   ##   ##   #   ##  ##  ##   ##\n"
+        " ####    ##   ##  #######           #####     ####    ##   ##   ####    ##   ##    #####           ####     ##   ##   ####    #######   #####    #####    #####   ####     ##   ##  #######  #### ##   #####\n\n"
+        "1. Método por Semáforo\n"
+        "2. Método com monitores POSIX\n"
+        "3. Método com monitores POSIX e Aging (Anti-Starvation)\n"
+        "4. Método com monitores POSIX e fila FIFO (Espera Limitada)\n"
+        "5. Método por Semáforo com hierarquia de recursos\n"
+        "6. Método por Semáforo com garçom (N-1 filósofos)\n"
+        "7. Método por Semáforo com tentativa e recuo exponencial\n"
+        "8. Método com monitores POSIX em memória compartilhada (Multiprocesso)\n"
+        "9. Relatório de contenção dos locks\n"
+        "10. Sair\n\n"
+        + help() +
+        "Escolha uma opção ou digite um comando: ";
+    }
+
+    static std::string help() {
+        return
+        "Comandos (um por linha, podem ser enviados vários de uma vez):\n"
+        "  start <tipo> [n=5] [think=1000-3000] [eat=3000] [workers=2] [quiet]\n"
+        "      tipos: semaphore posix aging fifo hierarchy butler backoff shm\n"
+        "  stop <id|all>         para uma mesa\n"
+        "  stats [id]            estatísticas de uma ou de todas as mesas\n"
+        "  snapshot <id|all>     estados, refeições e palitos lidos de uma vez\n"
+        "  subscribe <id|all>    passa a receber os eventos da mesa\n"
+        "  unsubscribe <id|all>  deixa de receber os eventos da mesa\n"
+        "  list                  lista as mesas da sessão\n"
+        "  profile               ativa o perfilador de locks ou mostra o relatório\n"
+        "  timers                atraso dos despertares de pensar/comer (jitter)\n"
+        "  budget                orçamento de threads/memória do servidor e fila de admissão\n"
+        "  help                  mostra esta ajuda\n"
+        "  quit                  para as mesas e encerra a sessão\n";
+    }
+
+    /**
+     * @brief Converte um número sem lançar exceções
+     * @return true se todo o texto era um número válido
+     */
+    static bool parseInt(const std::string& text, int& value) {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    /**
+     * @brief Executa uma linha de comando
+     * @return false se a sessão deve ser encerrada
+     */
+    bool handleLine(const std::string& line) {
+        std::istringstream input(line);
+        std::vector<std::string> args;
+        for (std::string word; input >> word;) {
+            args.push_back(word);
+        }
+        if (args.empty()) {
+            return true;
+        }
+
+        // Atalhos numéricos do menu
+        int option = 0;
+        if (args.size() == 1 && parseInt(args[0], option)) {
+            if (option >= 1 && option <= 8) {
+                args = {"start", TABLE_KINDS[option - 1]};
+            } else if (option == 9) {
+                args = {"profile"};
+            } else if (option == 10) {
+                args = {"quit"};
+            } else {
+                reply("Opção inválida. Por favor, selecione uma opção entre 1 e 10.\n");
+                return true;
+            }
+        }
+
+        const std::string& command = args[0];
+        if (command == "start") {
+            startTable(args);
+        } else if (command == "stop") {
+            forEachTarget(args, [](RunningTable& entry) { entry.stop(); }, "parando");
+        } else if (command == "subscribe") {
+            forEachTarget(args, [](RunningTable& entry) { entry.setSubscribed(true); }, "inscrito");
+        } else if (command == "unsubscribe") {
+            forEachTarget(args, [](RunningTable& entry) { entry.setSubscribed(false); }, "silenciado");
+        } else if (command == "stats") {
+            if (args.size() == 1) {
+                args.push_back("all");
+            }
+            forEachTarget(args, [this](RunningTable& entry) { reply(describe(entry) + "\n"); }, nullptr);
+        } else if (command == "snapshot") {
+            forEachTarget(args, [this](RunningTable& entry) { reply(describeSnapshot(entry) + "\n"); }, nullptr);
+        } else if (command == "list") {
+            if (tables.empty()) {
+                reply("nenhuma mesa\n");
+            }
+            for (auto& entry : tables) {
+                reply(std::format("mesa {} {} {}\n", entry->id, entry->kind, entry->status()));
+            }
+        } else if (command == "profile") {
+            if (!LockProfiler::enabled()) {
+                LockProfiler::enable();
+                reply("Perfilador de locks ativado. Use profile novamente para ver o relatório.\n");
+            } else {
+                reply(LockProfiler::report());
+            }
+        } else if (command == "timers") {
+            const LatencyHistogram& jitter = TimerWheel::jitter();
+            reply(std::format("{}: esperas={} jitter(µs) p50={} p99={} max={}\n",
+                              TimerWheel::enabled() ? "roda de temporização" : "sleep_for", jitter.count(),
+                              jitter.percentile(50), jitter.percentile(99), jitter.max()));
+        } else if (command == "budget") {
+            reply(ResourceGovernor::instance().report());
+        } else if (command == "help") {
+            reply(help());
+        } else if (command == "quit") {
+            reply("Saindo do programa...\n");
+            return false;
+        } else {
+            reply(std::format("erro: comando desconhecido '{}' (use help)\n", command));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Pede admissão para a mesa de "start" e a constrói e executa em uma thread própria
+     *
+     * Nada da mesa é alocado antes da admissão: um pedido recusado recebe só a recusa,
+     * e um pedido na fila só constrói a mesa quando o governador o admite.
+     */
+    void startTable(const std::vector<std::string>& args) {
+        if (args.size() < 2) {
+            reply("erro: uso: start <tipo> [n=5] [think=min-max] [eat=ms] [workers=2] [quiet]\n");
+            return;
+        }
+
+        int numPhilosophers = 5, thinkMin = 1000, thinkMax = 3000, eat = 3000, workers = 2;
+        bool quiet = false;
+        for (size_t i = 2; i < args.size(); i++) {
+            const std::string& arg = args[i];
+            size_t equals = arg.find('=');
+            std::string key = arg.substr(0, equals);
+            std::string value = equals == std::string::npos ? "" : arg.substr(equals + 1);
+            size_t dash = value.find('-');
+
+            bool ok = true;
+            if (arg == "quiet") {
+                quiet = true;
+            } else if (key == "n") {
+                ok = parseInt(value, numPhilosophers) && numPhilosophers >= 2 && numPhilosophers <= MAX_PHILOSOPHERS;
+            } else if (key == "think" && dash != std::string::npos) {
+                ok = parseInt(value.substr(0, dash), thinkMin) && parseInt(value.substr(dash + 1), thinkMax) &&
+                     thinkMin >= 0 && thinkMin <= thinkMax;
+            } else if (key == "eat") {
+                ok = parseInt(value, eat) && eat >= 0;
+            } else if (key == "workers") {
+                ok = parseInt(value, workers) && workers >= 1;
+            } else {
+                ok = false;
+            }
+            if (!ok) {
+                reply(std::format("erro: parâmetro inválido '{}'\n", arg));
+                return;
+            }
+        }
+
+        // Descarta as mesas que já terminaram
+        for (auto it = tables.begin(); it != tables.end();) {
+            if ((*it)->finished) {
+                (*it)->thread.join();
+                it = tables.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (tables.size() >= MAX_TABLES) {
+            reply(std::format("erro: limite de {} mesas por sessão\n", MAX_TABLES));
+            return;
+        }
+
+        if (std::find(std::begin(TABLE_KINDS), std::end(TABLE_KINDS), args[1]) == std::end(TABLE_KINDS)) {
+            reply(std::format("erro: tipo desconhecido '{}'\n", args[1]));
+            return;
+        }
+
+        auto entry = std::make_unique<RunningTable>();
+        entry->id = nextId;
+        entry->kind = args[1];
+        entry->numPhilosophers = numPhilosophers;
+        entry->thinkMin = thinkMin;
+        entry->thinkMax = thinkMax;
+        entry->eat = eat;
+        entry->workers = workers;
+        entry->subscribed = !quiet;
+        entry->ticket.threads = numPhilosophers;
+        entry->ticket.bytes = estimateBytes(numPhilosophers);
+
+        // Reserva threads e memória no orçamento do servidor antes de iniciar a mesa
+        ResourceGovernor& governor = ResourceGovernor::instance();
+        size_t position = 0;
+        ResourceGovernor::Decision decision = governor.submit(entry->ticket, &position);
+        if (decision == ResourceGovernor::Decision::TOO_LARGE) {
+            reply(std::format("erro: mesa com {} filósofos excede o orçamento do servidor "
+                              "({} threads, {} MiB)\n", numPhilosophers, governor.getMaxThreads(),
+                              governor.getMaxBytes() >> 20));
+            return;
+        }
+        if (decision == ResourceGovernor::Decision::QUEUE_FULL) {
+            reply(std::format("erro: servidor ocupado, fila de admissão cheia ({} mesas); tente mais tarde\n",
+                              governor.getMaxQueue()));
+            return;
+        }
+
+        nextId++;
+        bool queued = decision == ResourceGovernor::Decision::QUEUED;
+        entry->waiting = queued;
+        if (queued) {
+            reply(std::format("ok mesa {} ({}, {} filósofos) na fila de admissão, posição {}\n",
+                              entry->id, entry->kind, numPhilosophers, position));
+        } else {
+            reply(std::format("ok mesa {} ({}, {} filósofos)\n", entry->id, entry->kind, numPhilosophers));
+        }
+
+        RunningTable* running = entry.get();
+        entry->thread = std::thread([this, running, queued] {
+            if (queued) {
+                auto since = std::chrono::steady_clock::now();
+                bool admitted = ResourceGovernor::instance().waitForAdmission(running->ticket);
+                running->waiting = false;
+                if (!admitted) {
+                    reply(running->ticket.cancelled
+                              ? std::format("mesa {} removida da fila de admissão\n", running->id)
+                              : std::format("erro: mesa {} não admitida: espera na fila expirou\n", running->id));
+                    running->finished = true;
+                    return;
+                }
+                reply(std::format("mesa {} admitida após {}ms na fila\n", running->id,
+                                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - since).count()));
+            }
+            if (!running->stopRequested) {
+                buildTable(*running);
+                if (!running->stopRequested) {
+                    running->table->run();
+                }
+            }
+            ResourceGovernor::instance().release(running->ticket);
+            running->finished = true;
+        });
+        tables.push_back(std::move(entry));
+    }
+
+    /**
+     * @brief Constrói a mesa admitida, aplica tempos, prefixo e inscrição e a publica em live
+     */
+    void buildTable(RunningTable& entry) {
+        entry.table = createTable(entry.kind, entry.numPhilosophers, entry.workers);
+        for (int i = 0; i < entry.numPhilosophers; i++) {
+            entry.table->setPhilosopherTiming(i, entry.thinkMin, entry.thinkMax, entry.eat);
+        }
+        entry.table->getEvents().setPrefix(std::format("[mesa {}] ", entry.id));
+        entry.live = entry.table.get();
+        // Depois de publicar: um subscribe concorrente ou já foi lido aqui ou vê a mesa em live
+        entry.table->getEvents().setSubscribed(entry.subscribed);
+    }
+
+    /**
+     * @brief Memória estimada de uma mesa: pilha usada e objeto de cada filósofo, quadro e verificador
+     *
+     * Conta a parte da pilha que as threads realmente tocam (STACK_BYTES), não a reserva
+     * virtual de 8 MiB, que não ocupa memória física.
+     */
+    static size_t estimateBytes(int numPhilosophers) {
+        return numPhilosophers * (STACK_BYTES + sizeof(Philosopher)) + SnapshotBoard::bytesFor(numPhilosophers) +
+               SafetyChecker::bytesFor(numPhilosophers);
+    }
+
+    /**
+     * @brief Cria uma mesa pelo nome do tipo
+     * @return nullptr se o tipo for desconhecido
+     */
+    std::unique_ptr<DiningTable> createTable(const std::string& kind, int numPhilosophers, int workers) {
+        if (kind == "semaphore") {
+            return std::make_unique<SemaphoreDiningTable>(numPhilosophers, socket);
+        } else if (kind == "posix") {
+            return std::make_unique<PosixDiningTable>(numPhilosophers, socket);
+        } else if (kind == "aging") {
+            return std::make_unique<PosixAgingDiningTable>(numPhilosophers, socket);
+        } else if (kind == "fifo") {
+            return std::make_unique<PosixFairDiningTable>(numPhilosophers, socket);
+        } else if (kind == "hierarchy") {
+            return std::make_unique<SemaphoreDiningTable>(numPhilosophers, socket, SemaphoreStrategy::RESOURCE_HIERARCHY);
+        } else if (kind == "butler") {
+            return std::make_unique<SemaphoreDiningTable>(numPhilosophers, socket, SemaphoreStrategy::BUTLER);
+        } else if (kind == "backoff") {
+            return std::make_unique<SemaphoreDiningTable>(numPhilosophers, socket, SemaphoreStrategy::TRY_BACKOFF);
+        } else if (kind == "shm") {
+            return std::make_unique<SharedMemoryDiningTable>(numPhilosophers, socket, workers);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Aplica uma ação à mesa indicada em args[1] ("all" para todas)
+     * @param done Texto da confirmação (nullptr para não confirmar)
+     */
+    template <typename Action>
+    void forEachTarget(const std::vector<std::string>& args, Action action, const char* done) {
+        if (args.size() < 2) {
+            reply(std::format("erro: uso: {} <id|all>\n", args[0]));
+            return;
+        }
+
+        bool all = args[1] == "all";
+        int id = 0;
+        if (!all && !parseInt(args[1], id)) {
+            reply(std::format("erro: id inválido '{}'\n", args[1]));
+            return;
+        }
+
+        bool found = false;
+        for (auto& entry : tables) {
+            if (all || entry->id == id) {
+                action(*entry);
+                found = true;
+                if (done) {
+                    reply(std::format("ok mesa {} {}\n", entry->id, done));
+                }
+            }
+        }
+        if (!found && !all) {
+            reply(std::format("erro: mesa {} não existe\n", id));
+        }
+    }
+
+    /**
+     * @brief Cópia consistente de uma mesa: estado, refeições e palito segurado por filósofo
+     */
+    std::string describeSnapshot(RunningTable& entry) {
+        DiningTable* table = entry.live;
+        if (table == nullptr) {
+            return std::format("mesa {}: {}", entry.id, entry.finished ? "não chegou a executar" : "na fila de admissão");
+        }
+        TableSnapshot& view = snapshotView;
+        if (!table->snapshot(view)) {
+            return std::format("mesa {}: estado indisponível", entry.id);
+        }
+
+        std::string out = std::format("mesa {} versão={}", entry.id, view.version);
+        static const char* stateNames[] = {"pensando", "com fome", "comendo"};
+        for (size_t i = 0; i < view.states.size(); i++) {
+            out += std::format("\n  filósofo {}: {} refeições={} palito {}={}", i,
+                               stateNames[static_cast<int>(view.states[i])], view.meals[i], i,
+                               view.chopstickHolders[i] == SnapshotBoard::NO_HOLDER
+                                   ? std::string("livre")
+                                   : std::format("filósofo {}", view.chopstickHolders[i]));
+        }
+        return out;
+    }
+
+    /**
+     * @brief Linha de estatísticas de uma mesa
+     */
+    std::string describe(RunningTable& entry) {
+        DiningTable* table = entry.live;
+        return std::format("mesa {} {} ({} filósofos, {}){}", entry.id, entry.kind, entry.numPhilosophers,
+                           entry.status(), table ? ": " + table->stats() : std::string());
+    }
+};
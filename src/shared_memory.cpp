@@ -0,0 +1,427 @@
+#include "../include/dining_table.h"
+#include <iostream>
+#include <pthread.h>
+#include <unistd.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <new>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Implementação da mesa de jantar com monitores POSIX em memória compartilhada
+ *
+ * O mutex, as variáveis de condição e os estados dos filósofos ficam em um segmento
+ * criado com shm_open/mmap e inicializados com PTHREAD_PROCESS_SHARED. Os filósofos
+ * são distribuídos entre vários processos trabalhadores (filósofo i roda no processo
+ * i % numWorkers). O mutex é robusto: se um trabalhador morrer, os demais seguem e os
+ * filósofos dele são devolvidos ao estado THINKING.
+ */
+class SharedMemoryDiningTable : public DiningTable {
+public:
+    /**
+     * @brief Construtor para a mesa em memória compartilhada
+     * @param numPhilosophers O número de filósofos na mesa (padrão: 5)
+     * @param numWorkers O número de processos trabalhadores (padrão: 2)
+     */
+    SharedMemoryDiningTable(int numPhilosophers, int socketnum, int numWorkers = 2)
+        : DiningTable(numPhilosophers, socketnum),
+          numWorkers(std::max(1, std::min(numWorkers, numPhilosophers))) {
+        // Calcula o layout do segmento: cabeçalho, variáveis de condição, estados, quadro e verificador
+        condOffset = alignUp(sizeof(SharedHeader), alignof(pthread_cond_t));
+        stateOffset = alignUp(condOffset + numPhilosophers * sizeof(pthread_cond_t), alignof(State));
+        boardOffset = alignUp(stateOffset + numPhilosophers * sizeof(State), alignof(SnapshotBoard));
+        checkerOffset = alignUp(boardOffset + SnapshotBoard::bytesFor(numPhilosophers), alignof(SafetyChecker));
+        segmentSize = checkerOffset + SafetyChecker::bytesFor(numPhilosophers);
+
+        // Cria o segmento com um nome único e o remove do namespace logo após o mmap:
+        // os trabalhadores herdam o mapeamento pelo fork e nada sobra se o servidor cair
+        static std::atomic<int> counter{0};
+        std::string name = std::format("/philosophers-{}-{}", getpid(), counter++);
+
+        void* segment = MAP_FAILED;
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0) {
+            if (ftruncate(fd, segmentSize) == 0) {
+                segment = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            }
+            close(fd);
+            shm_unlink(name.c_str());
+        }
+        if (segment == MAP_FAILED) {
+            std::string msg = std::format("Erro ao criar a memória compartilhada: {}\n", std::strerror(errno));
+            events.send(msg);
+            return;
+        }
+        base = static_cast<char*>(segment);
+
+        // Inicializa o mutex compartilhado e robusto
+        shared = new (base) SharedHeader();
+        pthread_mutexattr_t mutexAttr;
+        pthread_mutexattr_init(&mutexAttr);
+        pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&shared->mutex, &mutexAttr);
+        pthread_mutexattr_destroy(&mutexAttr);
+
+        // Inicializa as variáveis de condição compartilhadas e os estados
+        for (int i = 0; i < numPhilosophers; i++) {
+            initCond(i);
+            new (&state(i)) State(State::THINKING);
+        }
+
+        // A inscrição do canal de eventos, o quadro da mesa e o verificador precisam ser
+        // vistos pelos processos trabalhadores
+        events.shareSubscribedFlag(&shared->subscribed);
+        useSnapshotBoard(SnapshotBoard::create(base + boardOffset, numPhilosophers));
+        useSafetyChecker(SafetyChecker::create(base + checkerOffset, numPhilosophers, &events));
+    }
+
+    /**
+     * @brief Destrutor para liberar recursos
+     */
+    ~SharedMemoryDiningTable() {
+        if (base == nullptr) {
+            return;
+        }
+        pthread_mutex_destroy(&shared->mutex);
+        for (size_t i = 0; i < philosophers.size(); i++) {
+            pthread_cond_destroy(&cond(i));
+        }
+        shared->~SharedHeader();
+        munmap(base, segmentSize);
+    }
+
+    /**
+     * @brief Executa a simulação, distribuindo os filósofos entre processos trabalhadores
+     */
+    void run() override {
+        if (base == nullptr) {
+            return; // O erro já foi informado no construtor
+        }
+
+        std::string msg = std::format("Iniciando simulação com {} filósofos em {} processos.\n",
+                                      philosophers.size(), numWorkers);
+        msg = msg + "Implementação usando monitores POSIX em memória compartilhada.\n";
+        msg = msg + "Esta implementação permite starvation.\n";
+        events.send(msg);
+
+        // Cria os processos trabalhadores. O filho herda só a thread que chamou fork, então
+        // todo lock global que ele usa precisa chegar livre: a roda de temporização e o
+        // registro do perfilador seguram os seus em handlers de pthread_atfork, a glibc faz
+        // o mesmo com o malloc, e o stderr (onde o verificador relata violações) fica
+        // travado aqui durante o fork. Os mutex dos filósofos desta mesa só são usados
+        // pelos trabalhadores
+        std::vector<pid_t> workers;
+        for (int w = 0; w < numWorkers; w++) {
+            flockfile(stderr);
+            pid_t pid = fork();
+            funlockfile(stderr);
+            if (pid == 0) {
+                closeInheritedDescriptors();
+                TimerWheel::resetAfterFork();
+                workerMain(w);
+                _exit(0);
+            }
+            if (pid < 0) {
+                msg = std::format("Falha ao criar o processo trabalhador {}: {}\n", w, std::strerror(errno));
+                events.send(msg);
+                continue;
+            }
+            workers.push_back(pid);
+        }
+
+        // Um observador por trabalhador: se o processo morrer, recupera os filósofos dele
+        std::vector<std::thread> watchers;
+        for (size_t w = 0; w < workers.size(); w++) {
+            watchers.emplace_back(&SharedMemoryDiningTable::watchWorker, this, static_cast<int>(w), workers[w]);
+        }
+        for (auto& watcher : watchers) {
+            watcher.join();
+        }
+
+        msg = "Simulação finalizada.\n";
+        events.send(msg);
+    }
+
+    /**
+     * @brief Para a execução da simulação em todos os processos
+     */
+    void stop() override {
+        if (shared != nullptr) {
+            shared->running = false;
+        }
+    }
+
+    /**
+     * @brief Retorna o número de refeições concluídas em todos os processos
+     */
+    uint64_t getMeals() const {
+        return shared != nullptr ? shared->meals.load(std::memory_order_relaxed) : 0;
+    }
+
+    /**
+     * @brief Resumo da mesa a partir do quadro em memória compartilhada
+     * Os trabalhadores publicam no mesmo quadro, então a leitura vê todos os processos
+     */
+    std::string stats() override {
+        if (shared == nullptr) {
+            return "memória compartilhada indisponível";
+        }
+        return DiningTable::stats() + std::format(" processos={}", numWorkers);
+    }
+
+private:
+    /**
+     * @brief Cabeçalho do segmento compartilhado
+     * Seguido de pthread_cond_t[N], State[N], do quadro da mesa (SnapshotBoard) e do
+     * verificador de segurança (SafetyChecker)
+     */
+    struct SharedHeader {
+        pthread_mutex_t mutex;             ///< Mutex robusto compartilhado entre processos
+        std::atomic<bool> running{true};   ///< Flag para controlar a execução dos trabalhadores
+        std::atomic<uint64_t> meals{0};    ///< Refeições concluídas
+        std::atomic<bool> subscribed{true}; ///< Inscrição do canal de eventos, vista pelos trabalhadores
+    };
+
+    int numWorkers;          ///< Número de processos trabalhadores
+    char* base = nullptr;            ///< Início do segmento mapeado
+    SharedHeader* shared = nullptr;  ///< Cabeçalho no início do segmento
+    size_t condOffset;       ///< Deslocamento do vetor de variáveis de condição
+    size_t stateOffset;      ///< Deslocamento do vetor de estados
+    size_t boardOffset;      ///< Deslocamento do quadro da mesa
+    size_t checkerOffset;    ///< Deslocamento do verificador de segurança
+    size_t segmentSize;      ///< Tamanho total do segmento
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    pthread_cond_t& cond(int i) {
+        return reinterpret_cast<pthread_cond_t*>(base + condOffset)[i];
+    }
+
+    /**
+     * @brief No processo trabalhador, fecha os descritores herdados do servidor
+     *
+     * O fork copia todos: o socket de escuta, os sockets das outras sessões (cujo quit
+     * só entregaria EOF ao cliente quando os trabalhadores saíssem) e o timerfd da roda.
+     * Ficam só stdin/stdout/stderr e o socket desta sessão.
+     */
+    void closeInheritedDescriptors() {
+        int keep = events.getSocket();
+        if (keep > 2) {
+            closeFrom(3, keep - 1);
+            closeFrom(keep + 1, ~0U);
+        } else {
+            closeFrom(3, ~0U);
+        }
+    }
+
+    static void closeFrom(unsigned first, unsigned last) {
+        if (first > last || close_range(first, last, 0) == 0) {
+            return;
+        }
+        // Kernel sem close_range: fecha um a um até o limite de descritores
+        long limit = sysconf(_SC_OPEN_MAX);
+        unsigned end = std::min<unsigned long>(last, limit > 0 ? limit - 1 : 1023);
+        for (unsigned fd = first; fd <= end; fd++) {
+            close(fd);
+        }
+    }
+
+    /**
+     * @brief (Re)inicializa a variável de condição de um filósofo, compartilhada entre processos
+     */
+    void initCond(int i) {
+        pthread_condattr_t condAttr;
+        pthread_condattr_init(&condAttr);
+        pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+        pthread_cond_init(&cond(i), &condAttr);
+        pthread_condattr_destroy(&condAttr);
+    }
+
+    State& state(int i) {
+        return reinterpret_cast<State*>(base + stateOffset)[i];
+    }
+
+    /**
+     * @brief Trava o mutex compartilhado, recuperando-o se o dono anterior morreu
+     */
+    void lock() {
+        if (pthread_mutex_lock(&shared->mutex) == EOWNERDEAD) {
+            pthread_mutex_consistent(&shared->mutex);
+        }
+    }
+
+    void unlock() {
+        pthread_mutex_unlock(&shared->mutex);
+    }
+
+    /**
+     * @brief Espera na variável de condição do filósofo
+     * @param philosopher_number ID do filósofo
+     */
+    void wait(int philosopher_number) {
+        if (pthread_cond_wait(&cond(philosopher_number), &shared->mutex) == EOWNERDEAD) {
+            pthread_mutex_consistent(&shared->mutex);
+        }
+    }
+
+    /**
+     * @brief Corpo do processo trabalhador: roda uma thread por filósofo atribuído
+     * @param worker Índice do trabalhador
+     */
+    void workerMain(int worker) {
+        std::vector<std::thread> threads;
+        for (size_t i = worker; i < philosophers.size(); i += numWorkers) {
+            threads.emplace_back(&SharedMemoryDiningTable::philosopherLifecycle, this, static_cast<int>(i));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Aguarda o término de um trabalhador e recupera a mesa se ele morreu
+     * @param worker Índice do trabalhador
+     * @param pid PID do processo
+     */
+    void watchWorker(int worker, pid_t pid) {
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+
+        if (!WIFSIGNALED(status)) {
+            return;
+        }
+
+        std::string msg = std::format("Processo trabalhador {} (pid {}) morreu com o sinal {}; "
+                                      "liberando os palitos dos seus filósofos\n",
+                                      worker, pid, WTERMSIG(status));
+        events.send(msg);
+
+        // Os filósofos do processo morto deixam a mesa; os vizinhos podem voltar a comer.
+        // A condição de cada um é recriada: um filósofo morto dentro de pthread_cond_wait
+        // continua contado como esperando, e pthread_cond_destroy no destrutor o esperaria
+        // para sempre. Só o próprio filósofo espera na sua condição, e os vizinhos só a
+        // sinalizam com o mutex travado e o filósofo com fome, então ninguém mais a usa
+        lock();
+        for (size_t i = worker; i < philosophers.size(); i += numWorkers) {
+            state(i) = State::THINKING;
+            initCond(i);
+            safetyChecker->releaseSeat(i);
+            snapshotBoard->releaseSeat(i);
+        }
+        for (size_t i = worker; i < philosophers.size(); i += numWorkers) {
+            test((i + philosophers.size() - 1) % philosophers.size());
+            test((i + 1) % philosophers.size());
+        }
+        unlock();
+    }
+
+    /**
+     * @brief Verifica se o filósofo pode comer
+     * @param philosopher_number ID do filósofo
+     * @return true se o filósofo pode comer, false caso contrário
+     */
+    bool canEat(int philosopher_number) {
+        int left = (philosopher_number + philosophers.size() - 1) % philosophers.size();
+        int right = (philosopher_number + 1) % philosophers.size();
+
+        return state(left) != State::EATING && state(right) != State::EATING;
+    }
+
+    /**
+     * @brief Tenta fazer o filósofo comer se possível
+     * @param philosopher_number ID do filósofo
+     */
+    void test(int philosopher_number) {
+        if (state(philosopher_number) == State::HUNGRY && canEat(philosopher_number)) {
+            // Filósofo pode comer
+            state(philosopher_number) = State::EATING;
+
+            // Sinaliza que o filósofo pode comer
+            pthread_cond_signal(&cond(philosopher_number));
+        }
+    }
+
+    /**
+     * @brief Implementação da interface do jantar dos filósofos em memória compartilhada
+     * Função pickup_forks - cada filósofo chama quando quer comer
+     * @param philosopher_number O número do filósofo (0 a n-1)
+     */
+    void pickup_forks(int philosopher_number) {
+        lock();
+
+        // Tenta pegar os palitos
+        state(philosopher_number) = State::HUNGRY;
+        test(philosopher_number);
+
+        // Se não conseguiu comer, espera até que possa
+        while (state(philosopher_number) == State::HUNGRY) {
+            events.emit("Filósofo ", philosopher_number, " está esperando para comer (pid ", getpid(), ")\n");
+
+            wait(philosopher_number);
+        }
+
+        // Pega os palitos
+        philosophers[philosopher_number]->pickUpLeftChopstick();
+        philosophers[philosopher_number]->pickUpRightChopstick();
+
+        unlock();
+    }
+
+    /**
+     * @brief Implementação da interface do jantar dos filósofos em memória compartilhada
+     * Função return_forks - cada filósofo chama quando termina de comer
+     * @param philosopher_number O número do filósofo (0 a n-1)
+     */
+    void return_forks(int philosopher_number) {
+        lock();
+
+        // Filósofo volta a pensar
+        state(philosopher_number) = State::THINKING;
+        shared->meals.fetch_add(1, std::memory_order_relaxed);
+
+        // Solta os palitos
+        philosophers[philosopher_number]->putDownLeftChopstick();
+        philosophers[philosopher_number]->putDownRightChopstick();
+
+        // Verifica se os filósofos vizinhos podem comer
+        int left = (philosopher_number + philosophers.size() - 1) % philosophers.size();
+        int right = (philosopher_number + 1) % philosophers.size();
+
+        test(left);
+        test(right);
+
+        unlock();
+    }
+
+    /**
+     * @brief Ciclo de vida de um filósofo dentro de um processo trabalhador
+     * @param philosopherId ID do filósofo
+     */
+    void philosopherLifecycle(int philosopherId) {
+        while (shared->running) {
+            // Pensar
+            philosophers[philosopherId]->think();
+
+            // Pegar os palitos
+            pickup_forks(philosopherId);
+
+            // Comer
+            philosophers[philosopherId]->eat();
+
+            // Soltar os palitos
+            return_forks(philosopherId);
+        }
+    }
+};